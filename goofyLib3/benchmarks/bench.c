@@ -0,0 +1,228 @@
+#if defined(__unix__) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE // clock_gettime and getrusage with -std=c11
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <time.h>
+#include <sys/resource.h>
+#endif
+
+#include "bench.h"
+
+double bench_now(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+#endif
+}
+
+void bench_resetPeakRss(void) {
+#ifdef __linux__
+    // "5" resets VmHWM (linux 4.0+), if it doesnt work the peak is just the process peak
+    FILE* file = fopen("/proc/self/clear_refs", "w");
+    if (file) {
+        fputs("5", file);
+        fclose(file);
+    }
+#endif
+}
+double bench_peakRss(void) {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return (double)counters.PeakWorkingSetSize;
+    return 0.0;
+#else
+#ifdef __linux__
+    FILE* file = fopen("/proc/self/status", "r");
+    if (file) {
+        char line[256];
+        double kilobytes = 0.0;
+        while (fgets(line, sizeof(line), file)) {
+            if (strncmp(line, "VmHWM:", 6) == 0) {
+                kilobytes = strtod(line + 6, NULL);
+                break;
+            }
+        }
+        fclose(file);
+        if (kilobytes > 0.0) return kilobytes * 1024.0;
+    }
+#endif
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+#ifdef __APPLE__
+    return (double)usage.ru_maxrss; // bytes on mac, kilobytes everywhere else
+#else
+    return (double)usage.ru_maxrss * 1024.0;
+#endif
+#endif
+}
+
+const char* bench_option(int argc, char** argv, const char* name) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (strcmp(argv[i], name) == 0) return argv[i + 1];
+    }
+    return NULL;
+}
+double bench_sizeOption(int argc, char** argv, const char* name, double fallback) {
+    const char* text = bench_option(argc, argv, name);
+    if (!text) return fallback;
+    char* end;
+    double value = strtod(text, &end);
+    if (end == text) {
+        fprintf(stderr, "Bad value for %s: %s\n", name, text);
+        return fallback;
+    }
+    switch (*end) {
+        case 'k': case 'K': value *= 1024.0; break;
+        case 'm': case 'M': value *= 1024.0 * 1024.0; break;
+        case 'g': case 'G': value *= 1024.0 * 1024.0 * 1024.0; break;
+        default: break;
+    }
+    return value;
+}
+BENCH_RUN bench_initRun(const char* program, int argc, char** argv) {
+    BENCH_RUN run;
+    memset(&run, 0, sizeof(run));
+    run.program = program;
+    run.outPath = bench_option(argc, argv, "--out");
+    run.baselinePath = bench_option(argc, argv, "--baseline");
+    run.threshold = bench_sizeOption(argc, argv, "--threshold", 10.0);
+    run.repeats = (int)bench_sizeOption(argc, argv, "--repeats", 3.0);
+    if (run.repeats < 1) run.repeats = 1;
+    return run;
+}
+
+BENCH_RESULT* bench_addResult(BENCH_RUN* run, const char* name, double items, double bytes, double seconds) {
+    if (run->count >= BENCH_MAX_RESULTS) {
+        fprintf(stderr, "Too many results, %s not stored\n", name);
+        return NULL;
+    }
+    BENCH_RESULT* result = &run->results[run->count++];
+    memset(result, 0, sizeof(*result));
+    snprintf(result->name, sizeof(result->name), "%s", name);
+    result->items = items;
+    result->bytes = bytes;
+    result->seconds = seconds;
+    result->nsPerItem = items > 0.0 ? seconds * 1e9 / items : 0.0;
+    result->mbPerSecond = bytes > 0.0 && seconds > 0.0 ? bytes / (1024.0 * 1024.0) / seconds : 0.0;
+    result->peakRssBytes = bench_peakRss();
+
+    printf("%-32s %12.2f ns/item", result->name, result->nsPerItem);
+    if (result->mbPerSecond > 0.0) printf(" %10.1f MB/s", result->mbPerSecond);
+    printf(" %10.1f MB peak\n", result->peakRssBytes / (1024.0 * 1024.0));
+    return result;
+}
+static int bench_compareDoubles(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+static double bench_percentile(const double* sorted, size_t count, double percentile) {
+    size_t index = (size_t)ceil((double)count * percentile / 100.0);
+    if (index > 0) index--;
+    if (index >= count) index = count - 1;
+    return sorted[index];
+}
+void bench_setPercentiles(BENCH_RESULT* result, double* samples, size_t count) {
+    if (!result || count == 0) return;
+    qsort(samples, count, sizeof(double), bench_compareDoubles);
+    result->p50 = bench_percentile(samples, count, 50.0);
+    result->p90 = bench_percentile(samples, count, 90.0);
+    result->p99 = bench_percentile(samples, count, 99.0);
+    printf("%-32s p50 %.0f ns, p90 %.0f ns, p99 %.0f ns\n", "", result->p50, result->p90, result->p99);
+}
+
+// the JSON has one result per line so the baseline can be read back without a JSON parser
+static int bench_writeJson(const BENCH_RUN* run, const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "Failed to open %s\n", path);
+        return 0;
+    }
+    fprintf(file, "{\"benchmark\":\"%s\",\"repeats\":%d,\"results\":[", run->program, run->repeats);
+    for (int i = 0; i < run->count; ++i) {
+        const BENCH_RESULT* r = &run->results[i];
+        fprintf(file, "%s\n{\"name\":\"%s\",\"items\":%.0f,\"bytes\":%.0f,\"seconds\":%.9f,\"nsPerItem\":%.3f,\"mbPerSecond\":%.3f,\"peakRssBytes\":%.0f",
+                i ? "," : "", r->name, r->items, r->bytes, r->seconds, r->nsPerItem, r->mbPerSecond, r->peakRssBytes);
+        if (r->p50 > 0.0) fprintf(file, ",\"p50\":%.1f,\"p90\":%.1f,\"p99\":%.1f", r->p50, r->p90, r->p99);
+        fprintf(file, "}");
+    }
+    fprintf(file, "\n]}\n");
+    int ok = ferror(file) == 0;
+    if (fclose(file) != 0) ok = 0;
+    if (!ok) fprintf(stderr, "Failed to write %s\n", path);
+    return ok;
+}
+// returns the nsPerItem of name in a file bench_writeJson wrote, -1 if it isnt there
+static double bench_baselineValue(const char* text, const char* name) {
+    char key[96];
+    snprintf(key, sizeof(key), "{\"name\":\"%s\",", name);
+    const char* line = strstr(text, key);
+    if (!line) return -1.0;
+    const char* lineEnd = strchr(line, '\n');
+    const char* value = strstr(line, "\"nsPerItem\":");
+    if (!value || (lineEnd && value > lineEnd)) return -1.0;
+    return strtod(value + 12, NULL);
+}
+static int bench_compareBaseline(const BENCH_RUN* run) {
+    FILE* file = fopen(run->baselinePath, "rb");
+    if (!file) {
+        fprintf(stderr, "Failed to open baseline %s\n", run->baselinePath);
+        return 1;
+    }
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char* text = (char*)malloc((size_t)(length > 0 ? length : 0) + 1);
+    if (!text) {
+        fclose(file);
+        return 1;
+    }
+    size_t got = fread(text, 1, (size_t)(length > 0 ? length : 0), file);
+    text[got] = '\0';
+    fclose(file);
+
+    int regressions = 0;
+    printf("\nCompared with %s (regression above +%.1f%%):\n", run->baselinePath, run->threshold);
+    for (int i = 0; i < run->count; ++i) {
+        const BENCH_RESULT* r = &run->results[i];
+        double old = bench_baselineValue(text, r->name);
+        if (old < 0.0) {
+            printf("  %-32s new\n", r->name);
+            continue;
+        }
+        double change = old > 0.0 ? (r->nsPerItem - old) / old * 100.0 : 0.0;
+        char regressed = change > run->threshold;
+        regressions += regressed;
+        printf("  %-32s %12.2f -> %12.2f ns/item %+7.1f%%%s\n", r->name, old, r->nsPerItem, change, regressed ? "  REGRESSION" : "");
+    }
+    free(text);
+    if (regressions) printf("%d regression(s)\n", regressions);
+    return regressions ? 2 : 0;
+}
+int bench_finish(BENCH_RUN* run) {
+    char defaultPath[256];
+    const char* path = run->outPath;
+    if (!path) {
+        snprintf(defaultPath, sizeof(defaultPath), "%s.json", run->program);
+        path = defaultPath;
+    }
+    if (!bench_writeJson(run, path)) return 1;
+    printf("Wrote %s\n", path);
+    return run->baselinePath ? bench_compareBaseline(run) : 0;
+}
@@ -0,0 +1,52 @@
+#ifndef GOOFY_BENCH_H
+#define GOOFY_BENCH_H
+
+// stuff both benchmark programs share: a clock, peak memory, the JSON results and the baseline check
+
+#include <stddef.h>
+
+#define BENCH_MAX_RESULTS 256
+
+typedef struct {
+    char name[64];
+    double items; // vertices, meshes or frames, whatever nsPerItem is per
+    double bytes; // bytes read or uploaded for MB/s, 0 = no MB/s
+    double seconds; // best run
+    double nsPerItem;
+    double mbPerSecond;
+    double p50, p90, p99; // nanoseconds per item, 0 = not measured (only benchmarks with per frame samples have them)
+    double peakRssBytes; // peak resident memory while the case ran
+} BENCH_RESULT;
+
+typedef struct {
+    const char* program;
+    const char* outPath; // --out, default <program>.json
+    const char* baselinePath; // --baseline, a JSON file an earlier run wrote
+    double threshold; // --threshold, percent nsPerItem can get worse before it counts as a regression (default 10)
+    int repeats; // --repeats, cases keep their best run (default 3)
+    BENCH_RESULT results[BENCH_MAX_RESULTS];
+    int count;
+} BENCH_RUN;
+
+double bench_now(void);
+// Seconds from some fixed point, monotonic.
+void bench_resetPeakRss(void);
+// Starts a new peak memory measurement (linux only, elsewhere the peak is the peak of the whole process so far).
+double bench_peakRss(void);
+// Peak resident memory in bytes since bench_resetPeakRss, 0 if the OS cant tell.
+
+const char* bench_option(int argc, char** argv, const char* name);
+// Returns the value after --name, NULL if it isnt there.
+double bench_sizeOption(int argc, char** argv, const char* name, double fallback);
+// Same but parsed as a number, with k/m/g (1024) or e notation (1e8).
+BENCH_RUN bench_initRun(const char* program, int argc, char** argv);
+// Reads --out, --baseline, --threshold and --repeats.
+
+BENCH_RESULT* bench_addResult(BENCH_RUN* run, const char* name, double items, double bytes, double seconds);
+// Stores a case and prints it. seconds is the total time for all items.
+void bench_setPercentiles(BENCH_RESULT* result, double* samples, size_t count);
+// Sorts the samples (nanoseconds per item) and keeps p50/p90/p99.
+int bench_finish(BENCH_RUN* run);
+// Writes the JSON and compares with the baseline. Returns the exit code: 0 ok, 1 file error, 2 regression.
+
+#endif
@@ -0,0 +1,219 @@
+// cpu_bench: times the parts of the library that dont touch OpenGL, so it needs no window or context.
+// goofy_objMesh / goofy_objMeshParallel on generated OBJ files (1 KB up to 1 GB) and the mesh functions on spheres,
+// reports ns per vertex, MB/s and peak memory per case as JSON.
+//
+// cpu_bench [--max-obj-bytes 64m] [--max-vertices 1e6] [--threads 0] [--dir .] [--keep 1]
+//           [--repeats 3] [--out cpu_bench.json] [--baseline old.json] [--threshold 10]
+// --max-obj-bytes 1g generates the 1 GB file too (needs the disk space and a few GB of memory for the mesh).
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "goofyLib3.h"
+#include "bench.h"
+
+#define BENCH_OBJ_BYTES_PER_VERTEX 100.0 // about what bench_writeObj writes per grid vertex (a v line and two faces)
+
+// writes a side x side grid of v/vt/vn triangles with the texture tiled once per quad (4 vt, 1 vn),
+// returns the file size (0 = failed) and the number of v lines in positions
+static double bench_writeObj(const char* path, size_t targetBytes, double* positions) {
+    size_t side = (size_t)sqrt((double)targetBytes / BENCH_OBJ_BYTES_PER_VERTEX);
+    if (side < 2) side = 2;
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "Failed to create %s\n", path);
+        return 0.0;
+    }
+    static char block[1 << 16];
+    setvbuf(file, block, _IOFBF, sizeof(block));
+    fprintf(file, "# cpu_bench grid %zux%zu\n", side, side);
+    for (size_t y = 0; y < side; ++y) {
+        for (size_t x = 0; x < side; ++x) {
+            float u = (float)x / (float)(side - 1), v = (float)y / (float)(side - 1);
+            float height = 0.25f * sinf(u * 12.0f) * cosf(v * 12.0f);
+            fprintf(file, "v %.6f %.6f %.6f\n", u * 100.0f - 50.0f, height, v * 100.0f - 50.0f);
+        }
+    }
+    fprintf(file, "vt 0.000000 0.000000\nvt 1.000000 0.000000\nvt 1.000000 1.000000\nvt 0.000000 1.000000\n");
+    fprintf(file, "vn 0.000000 1.000000 0.000000\n");
+    for (size_t y = 0; y + 1 < side; ++y) {
+        for (size_t x = 0; x + 1 < side; ++x) {
+            size_t a = y * side + x + 1, b = a + 1, c = a + side + 1, d = a + side;
+            fprintf(file, "f %zu/1/1 %zu/2/1 %zu/3/1\nf %zu/1/1 %zu/3/1 %zu/4/1\n", a, b, c, a, c, d);
+        }
+    }
+    double bytes = (double)ftell(file);
+    int ok = ferror(file) == 0;
+    if (fclose(file) != 0) ok = 0;
+    if (!ok) {
+        fprintf(stderr, "Failed to write %s (disk full?)\n", path);
+        remove(path);
+        return 0.0;
+    }
+    *positions = (double)(side * side);
+    return bytes;
+}
+
+static void bench_sizeName(char* name, size_t length, double bytes) {
+    if (bytes >= 1024.0 * 1024.0 * 1024.0) snprintf(name, length, "%.0fG", bytes / (1024.0 * 1024.0 * 1024.0));
+    else if (bytes >= 1024.0 * 1024.0) snprintf(name, length, "%.0fM", bytes / (1024.0 * 1024.0));
+    else snprintf(name, length, "%.0fK", bytes / 1024.0);
+}
+
+static void bench_loaders(BENCH_RUN* run, double maxBytes, unsigned int threads, const char* dir, char keep) {
+    for (double target = 1024.0; target <= maxBytes; target *= 16.0) {
+        char size[16], path[512], name[64];
+        bench_sizeName(size, sizeof(size), target);
+        snprintf(path, sizeof(path), "%s/cpu_bench_%s.obj", dir, size);
+        double positions = 0.0;
+        double bytes = bench_writeObj(path, (size_t)target, &positions);
+        if (bytes <= 0.0) return;
+
+        // per OBJ position (v line), the mesh vertex count depends on how the loader splits corners
+        for (int parallel = 0; parallel < 2; ++parallel) {
+            double best = 0.0;
+            char empty = 0;
+            bench_resetPeakRss();
+            for (int r = 0; r < run->repeats; ++r) {
+                double start = bench_now();
+                GOOFY_MESH mesh = parallel ? goofy_objMeshParallel(path, threads) : goofy_objMesh(path);
+                double seconds = bench_now() - start;
+                empty = mesh.vertexCount == 0;
+                goofy_freeMesh(&mesh);
+                if (r == 0 || seconds < best) best = seconds;
+            }
+            snprintf(name, sizeof(name), "%s/%s", parallel ? "objMeshParallel" : "objMesh", size);
+            if (empty) fprintf(stderr, "%s gave an empty mesh\n", path);
+            else bench_addResult(run, name, positions, bytes, best);
+        }
+        if (!keep) remove(path);
+    }
+}
+
+// a sphere with about vertexCount vertices (twice as many sectors as stacks)
+static GOOFY_MESH* bench_sphere(double vertexCount) {
+    unsigned int stacks = (unsigned int)sqrt(vertexCount / 2.0);
+    if (stacks < 2) stacks = 2;
+    return goofy_createSphere(1.0f, stacks * 2, stacks);
+}
+
+static void bench_meshFunctions(BENCH_RUN* run, double maxVertices) {
+    for (double target = 1000.0; target <= maxVertices * 1.001; target *= 10.0) {
+        char name[64];
+        char size[16];
+        snprintf(size, sizeof(size), "1e%.0f", log10(target));
+        bench_resetPeakRss();
+
+        double best = 0.0;
+        GOOFY_MESH* sphere = NULL;
+        for (int r = 0; r < run->repeats; ++r) {
+            if (sphere) {
+                goofy_freeMesh(sphere);
+                free(sphere);
+            }
+            double start = bench_now();
+            sphere = bench_sphere(target);
+            double seconds = bench_now() - start;
+            if (!sphere) {
+                fprintf(stderr, "Out of memory for a %s vertex sphere\n", size);
+                return;
+            }
+            if (r == 0 || seconds < best) best = seconds;
+        }
+        double vertices = (double)sphere->vertexCount;
+        double bytes = vertices * sizeof(GOOFY_VERTICE) + (double)sphere->indexCount * sizeof(unsigned int);
+        snprintf(name, sizeof(name), "createSphere/%s", size);
+        bench_addResult(run, name, vertices, bytes, best);
+
+        // the in place functions only write the vertices
+        double vertexBytes = vertices * sizeof(GOOFY_VERTICE);
+        for (int function = 0; function < 4; ++function) {
+            static const char* names[] = {"transformMesh", "rotateMesh", "resizeMesh", "setMeshColor"};
+            best = 0.0;
+            for (int r = 0; r < run->repeats; ++r) {
+                double start = bench_now();
+                switch (function) {
+                    case 0: goofy_transformMesh(sphere, 0.5f, -0.25f, 1.0f); break;
+                    case 1: goofy_rotateMesh(sphere, 0.3f, 0.0f, 1.0f, 0.0f); break;
+                    case 2: goofy_resizeMesh(sphere, 1.01f, 0.99f, 1.0f); break;
+                    default: goofy_setMeshColor(sphere, 0.2f, 0.4f, 0.6f); break;
+                }
+                double seconds = bench_now() - start;
+                if (r == 0 || seconds < best) best = seconds;
+            }
+            snprintf(name, sizeof(name), "%s/%s", names[function], size);
+            bench_addResult(run, name, vertices, vertexBytes, best);
+        }
+
+        best = 0.0;
+        for (int r = 0; r < run->repeats; ++r) {
+            double start = bench_now();
+            GOOFY_MESH* clone = goofy_cloneMesh(sphere);
+            double seconds = bench_now() - start;
+            if (!clone) {
+                fprintf(stderr, "Out of memory cloning a %s vertex sphere\n", size);
+                break;
+            }
+            goofy_freeMesh(clone);
+            free(clone);
+            if (r == 0 || seconds < best) best = seconds;
+        }
+        snprintf(name, sizeof(name), "cloneMesh/%s", size);
+        if (best > 0.0) bench_addResult(run, name, vertices, bytes, best);
+
+        goofy_freeMesh(sphere);
+        free(sphere);
+    }
+}
+
+// appending a cube over and over, every append copies everything so far (the way editors build meshes up)
+static void bench_append(BENCH_RUN* run) {
+    static const size_t counts[] = {100, 1000, 3000};
+    GOOFY_MESH cube = goofy_cubeMesh(0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f);
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+        double best = 0.0, vertices = 0.0, bytes = 0.0;
+        bench_resetPeakRss();
+        for (int r = 0; r < run->repeats; ++r) {
+            GOOFY_MESH* first = goofy_cloneMesh(&cube);
+            if (!first) return;
+            GOOFY_MESH result = *first;
+            free(first);
+            double copied = 0.0;
+            double start = bench_now();
+            for (size_t i = 1; i < counts[c]; ++i) {
+                GOOFY_MESH grown = goofy_appendMesh(&result, &cube);
+                copied += (double)grown.vertexCount * sizeof(GOOFY_VERTICE) + (double)grown.indexCount * sizeof(unsigned int);
+                goofy_freeMesh(&result);
+                result = grown;
+            }
+            double seconds = bench_now() - start;
+            vertices = (double)result.vertexCount;
+            bytes = copied;
+            goofy_freeMesh(&result);
+            if (r == 0 || seconds < best) best = seconds;
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "appendMesh/x%zu", counts[c]);
+        bench_addResult(run, name, vertices, bytes, best);
+    }
+    goofy_freeMesh(&cube);
+}
+
+int main(int argc, char** argv) {
+    BENCH_RUN run = bench_initRun("cpu_bench", argc, argv);
+    double maxBytes = bench_sizeOption(argc, argv, "--max-obj-bytes", 64.0 * 1024.0 * 1024.0);
+    double maxVertices = bench_sizeOption(argc, argv, "--max-vertices", 1e6);
+    unsigned int threads = (unsigned int)bench_sizeOption(argc, argv, "--threads", 0);
+    const char* dir = bench_option(argc, argv, "--dir");
+    char keep = bench_sizeOption(argc, argv, "--keep", 0) != 0.0;
+
+    printf("OBJ loading (files up to %.0f MB in %s)\n", maxBytes / (1024.0 * 1024.0), dir ? dir : ".");
+    bench_loaders(&run, maxBytes, threads, dir ? dir : ".", keep);
+    printf("\nmesh functions (spheres up to %.0f vertices)\n", maxVertices);
+    bench_meshFunctions(&run, maxVertices);
+    printf("\nappending\n");
+    bench_append(&run);
+
+    return bench_finish(&run);
+}
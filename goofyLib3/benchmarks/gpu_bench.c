@@ -0,0 +1,200 @@
+// gpu_bench: draws synthetic scenes in a headless context and measures the cpu side of rendering.
+// goofy_renderMesh submission per mesh, goofy_drawAllMeshes cpu time, bytes uploaded and frame time percentiles, as JSON.
+//
+// gpu_bench [--cubes 10000] [--spheres 1000] [--obj file.obj] [--frames 200] [--warmup 10] [--gl 4.5]
+//           [--shaders shaders] [--stats stats.json] [--out gpu_bench.json] [--baseline old.json] [--threshold 10]
+// On linux without a display, run it with GLFW 3.4's null platform + OSMesa, or EGL on Mesa (LIBGL_ALWAYS_SOFTWARE=1 for llvmpipe).
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "goofyLib3.h"
+#include "bench.h"
+
+typedef struct {
+    const char* name;
+    GOOFY_MESH* meshes;
+    size_t meshCount;
+    char retained; // added as mesh slots once, frames only draw
+} BENCH_SCENE;
+
+typedef struct {
+    GLuint program;
+    GOOFY_TEXTURE_ARRAY* textures;
+    int frames;
+    int warmup;
+} BENCH_SETTINGS;
+
+// spreads count meshes over a grid in clip space (-0.9 to 0.9), returns the cell size
+static float bench_gridCell(size_t count, size_t index, float* x, float* y) {
+    size_t side = 1;
+    while (side * side < count) side++;
+    float cell = 1.8f / (float)side;
+    *x = -0.9f + cell * ((float)(index % side) + 0.5f);
+    *y = -0.9f + cell * ((float)(index / side) + 0.5f);
+    return cell;
+}
+static GOOFY_MESH* bench_makeCubes(size_t count) {
+    GOOFY_MESH* meshes = (GOOFY_MESH*)malloc(sizeof(GOOFY_MESH) * (count ? count : 1));
+    if (!meshes) return NULL;
+    for (size_t i = 0; i < count; ++i) {
+        float x, y;
+        float half = bench_gridCell(count, i, &x, &y) * 0.35f;
+        meshes[i] = goofy_cubeMesh(x, y, 0.0f, half, half, half, 1.0f, 1.0f);
+    }
+    return meshes;
+}
+static GOOFY_MESH* bench_makeSpheres(size_t count) {
+    GOOFY_MESH* meshes = (GOOFY_MESH*)malloc(sizeof(GOOFY_MESH) * (count ? count : 1));
+    if (!meshes) return NULL;
+    for (size_t i = 0; i < count; ++i) {
+        float x, y;
+        float radius = bench_gridCell(count, i, &x, &y) * 0.4f;
+        GOOFY_MESH* sphere = goofy_createSphere(radius, 32, 16);
+        if (!sphere) {
+            memset(&meshes[i], 0, sizeof(GOOFY_MESH));
+            continue;
+        }
+        goofy_transformMesh(sphere, x, y, 0.0f);
+        meshes[i] = *sphere;
+        free(sphere);
+    }
+    return meshes;
+}
+static void bench_freeMeshes(GOOFY_MESH* meshes, size_t count) {
+    for (size_t i = 0; meshes && i < count; ++i) goofy_freeMesh(&meshes[i]);
+    free(meshes);
+}
+
+static void bench_runScene(BENCH_RUN* run, const BENCH_SETTINGS* settings, const BENCH_SCENE* scene) {
+    if (scene->meshCount == 0) return;
+    size_t vertices = 0, indices = 0;
+    for (size_t i = 0; i < scene->meshCount; ++i) {
+        vertices += scene->meshes[i].vertexCount;
+        indices += scene->meshes[i].indexCount;
+    }
+    printf("\n%s: %zu meshes, %zu vertices, %zu indices\n", scene->name, scene->meshCount, vertices, indices);
+
+    // starts at the full size so growing doesnt show up in the timings (the warmup frames would hide it anyway)
+    GOOFY_BUFFER buffer = goofy_initBuffer((GLuint)vertices, (GLuint)indices, scene->meshCount);
+    if (scene->retained) {
+        for (size_t i = 0; i < scene->meshCount; ++i) goofy_addMeshSlot(&buffer, &scene->meshes[i]);
+    }
+
+    int frames = settings->frames;
+    double* submitSamples = (double*)malloc(sizeof(double) * (size_t)frames);
+    double* drawSamples = (double*)malloc(sizeof(double) * (size_t)frames);
+    double* frameSamples = (double*)malloc(sizeof(double) * (size_t)frames);
+    if (!submitSamples || !drawSamples || !frameSamples) {
+        fprintf(stderr, "Out of memory\n");
+        free(submitSamples);
+        free(drawSamples);
+        free(frameSamples);
+        goofy_freeBuffer(&buffer);
+        return;
+    }
+    double submitTime = 0.0, drawTime = 0.0, frameTime = 0.0, bytesUploaded = 0.0;
+    bench_resetPeakRss();
+    for (int frame = -settings->warmup; frame < frames; ++frame) {
+        if (frame == 0) goofy_resetStats(); // the histograms only hold the measured frames
+        double frameStart = bench_now();
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        if (!scene->retained) {
+            for (size_t i = 0; i < scene->meshCount; ++i) goofy_renderMesh(&buffer, &scene->meshes[i]);
+        }
+        double submitted = bench_now();
+        goofy_drawAllMeshes(&buffer, settings->program, settings->textures);
+        double drawn = bench_now();
+        glFinish(); // the frame time includes the gpu, otherwise the driver just queues frames up
+        goofy_endStatsFrame();
+        double frameEnd = bench_now();
+        if (frame < 0) continue;
+
+        submitSamples[frame] = (submitted - frameStart) * 1e9 / (double)scene->meshCount;
+        drawSamples[frame] = (drawn - submitted) * 1e9;
+        frameSamples[frame] = (frameEnd - frameStart) * 1e9;
+        submitTime += submitted - frameStart;
+        drawTime += drawn - submitted;
+        frameTime += frameEnd - frameStart;
+        bytesUploaded += (double)goofy_getStats()->lastFrame.bytesUploaded;
+    }
+
+    char name[64];
+    if (!scene->retained) {
+        snprintf(name, sizeof(name), "%s/submit", scene->name);
+        bench_setPercentiles(bench_addResult(run, name, (double)scene->meshCount * frames, bytesUploaded, submitTime), submitSamples, (size_t)frames);
+    }
+    snprintf(name, sizeof(name), "%s/draw", scene->name);
+    bench_setPercentiles(bench_addResult(run, name, frames, scene->retained ? bytesUploaded : 0.0, drawTime), drawSamples, (size_t)frames);
+    snprintf(name, sizeof(name), "%s/frame", scene->name);
+    bench_setPercentiles(bench_addResult(run, name, frames, 0.0, frameTime), frameSamples, (size_t)frames);
+    printf("%-32s %.0f bytes uploaded per frame, %llu draw calls per frame\n", "", bytesUploaded / frames,
+           (unsigned long long)goofy_getStats()->lastFrame.drawCalls);
+
+    free(submitSamples);
+    free(drawSamples);
+    free(frameSamples);
+    goofy_freeBuffer(&buffer);
+}
+
+int main(int argc, char** argv) {
+    BENCH_RUN run = bench_initRun("gpu_bench", argc, argv);
+    run.repeats = 1; // every frame is a sample, --frames is the repeat count here
+    BENCH_SETTINGS settings;
+    settings.frames = (int)bench_sizeOption(argc, argv, "--frames", 200);
+    settings.warmup = (int)bench_sizeOption(argc, argv, "--warmup", 10);
+    if (settings.frames < 1) settings.frames = 1;
+    if (settings.warmup < 0) settings.warmup = 0;
+    size_t cubeCount = (size_t)bench_sizeOption(argc, argv, "--cubes", 10000);
+    size_t sphereCount = (size_t)bench_sizeOption(argc, argv, "--spheres", 1000);
+    const char* objPath = bench_option(argc, argv, "--obj");
+    const char* shaderDir = bench_option(argc, argv, "--shaders");
+    const char* statsPath = bench_option(argc, argv, "--stats");
+    const char* version = bench_option(argc, argv, "--gl");
+    int major = 4, minor = 5;
+    if (version && sscanf(version, "%d.%d", &major, &minor) != 2) {
+        fprintf(stderr, "--gl wants major.minor, like 4.5\n");
+        return 1;
+    }
+
+    GLFWwindow* window = goofy_initHeadless(512, 512, major, minor);
+    if (!window) return 1;
+
+    char vertexPath[512], fragmentPath[512];
+    snprintf(vertexPath, sizeof(vertexPath), "%s/bench.vert", shaderDir ? shaderDir : "shaders");
+    snprintf(fragmentPath, sizeof(fragmentPath), "%s/bench.frag", shaderDir ? shaderDir : "shaders");
+    settings.program = goofy_initShaders(vertexPath, fragmentPath);
+    GOOFY_TEXTURE_ARRAY textures = goofy_initTextures(4, 4, 1);
+    settings.textures = &textures;
+    glEnable(GL_DEPTH_TEST);
+
+    BENCH_SCENE scenes[4];
+    int sceneCount = 0;
+    GOOFY_MESH* cubes = bench_makeCubes(cubeCount);
+    GOOFY_MESH* spheres = bench_makeSpheres(sphereCount);
+    GOOFY_MESH obj = {0};
+    if (cubes) {
+        scenes[sceneCount++] = (BENCH_SCENE){"cubes", cubes, cubeCount, 0};
+        scenes[sceneCount++] = (BENCH_SCENE){"cubeSlots", cubes, cubeCount, 1};
+    }
+    if (spheres) scenes[sceneCount++] = (BENCH_SCENE){"spheres", spheres, sphereCount, 0};
+    if (objPath) {
+        obj = goofy_objMeshParallel(objPath, 0);
+        if (obj.vertexCount) scenes[sceneCount++] = (BENCH_SCENE){"obj", &obj, 1, 0};
+    }
+    for (int i = 0; i < sceneCount; ++i) bench_runScene(&run, &settings, &scenes[i]);
+
+    if (statsPath) goofy_writeStatsJson(statsPath);
+    int result = bench_finish(&run);
+
+    bench_freeMeshes(cubes, cubeCount);
+    bench_freeMeshes(spheres, sphereCount);
+    goofy_freeMesh(&obj);
+    goofy_freeTextureArray(&textures);
+    glfwDestroyWindow(window);
+    goofy_terminate();
+    return result;
+}
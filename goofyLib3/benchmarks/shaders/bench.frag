@@ -0,0 +1,11 @@
+#version 330 core
+in vec3 vColor;
+in vec3 vTexCoords;
+
+uniform sampler2DArray textureArray;
+
+out vec4 fragColor;
+
+void main() {
+    fragColor = vec4(vColor, 1.0) * (0.5 + 0.5 * texture(textureArray, vTexCoords));
+}
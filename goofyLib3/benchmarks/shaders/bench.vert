@@ -0,0 +1,17 @@
+#version 330 core
+// vertex layout of GOOFY_VERTICE (packed buffers use the same locations)
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 color;
+layout(location = 2) in vec3 normal;
+layout(location = 3) in vec2 texCoords;
+layout(location = 4) in int texIndex;
+
+out vec3 vColor;
+out vec3 vTexCoords;
+
+void main() {
+    // the benchmark scenes are already in clip space
+    gl_Position = vec4(position.xy, position.z * 0.5, 1.0);
+    vColor = color * (0.6 + 0.4 * abs(normal.z));
+    vTexCoords = vec3(texCoords, float(max(texIndex, 0)));
+}
@@ -1,19 +1,57 @@
 // Includes
+#if defined(__unix__) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE // clock_gettime, mmap, madvise and sysconf when compiling with -std=c11
+#endif
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <stdint.h>
 #include <math.h>
+#include <limits.h>
+#include <stdatomic.h>
+
+// goofy_clockNow, a monotonic clock that works without glfwInit
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+// goofy_objMeshParallel maps the file and parses it with pthreads, everywhere else it just calls goofy_objMesh
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#define GOOFY_PARALLEL_OBJ
+#endif
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h> 
 
+// cpu culling tests this many spheres per instruction
+#if defined(__AVX__)
+#include <immintrin.h>
+#define GOOFY_CULL_WIDTH 8
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define GOOFY_CULL_WIDTH 4
+#else
+#define GOOFY_CULL_WIDTH 1
+#endif
+
 #include "goofyLib3.h"
 #include "shaderloader.h"
 
 // stuff
 #define VERTEX_MEMORY_SIZE sizeof(GOOFY_VERTICE)
+#define GOOFY_INDEX_UNIT sizeof(unsigned short) // index offsets and sizes in a buffer count 16 bit units
+#define GOOFY_DRAW_DATA_HEADER 16 // goofySlotCount in front of the slot draw data, padded to the struct alignment
 #define STB_IMAGE_IMPLEMENTATION
-#define INCREASE 2048
+#define GOOFY_OBJ_BLOCK (1 << 20) // goofy_objMesh reads the file in blocks of this size
 #define MAX_TRASH 64
 #define PI 3.14159265358979323846
 #include "stb_image.h"
@@ -32,6 +70,390 @@ sizeof(long double) = 16
 GOOFY_TRASH_BATCH* goofy_trashRegistry[MAX_TRASH];
 short goofy_trashRegistryCount = 0;
 
+// uniform tables of every program (goofy_getShader)
+static GOOFY_SHADER** goofy_shaderRegistry = NULL;
+static int goofy_shaderRegistryCount = 0;
+static int goofy_shaderRegistryCapacity = 0;
+
+// source of mesh versions, every edit anywhere gets a new one so a freed and reused mesh address cant look unchanged
+static atomic_uint goofy_meshVersions = 0;
+static unsigned int goofy_nextMeshVersion(void) {
+    unsigned int version = atomic_fetch_add(&goofy_meshVersions, 1) + 1;
+    return version ? version : atomic_fetch_add(&goofy_meshVersions, 1) + 1; // 0 means untracked
+}
+// fresh state for a mesh the library just made
+static void goofy_initMeshState(GOOFY_MESH* mesh) {
+    mesh->boundsValid = 0;
+    mesh->version = goofy_nextMeshVersion();
+    mesh->dirtySince = mesh->version;
+    mesh->dirtyVertexStart = mesh->dirtyVertexEnd = 0;
+    mesh->dirtyIndexStart = mesh->dirtyIndexEnd = 0;
+}
+// called after an upload, the mesh is now clean relative to its current version
+static void goofy_cleanMesh(GOOFY_MESH* mesh) {
+    mesh->dirtySince = mesh->version;
+    mesh->dirtyVertexStart = mesh->dirtyVertexEnd = 0;
+    mesh->dirtyIndexStart = mesh->dirtyIndexEnd = 0;
+}
+static void goofy_extendRange(size_t* start, size_t* end, size_t first, size_t count) {
+    if (count == 0) return;
+    if (*start >= *end) {
+        *start = first;
+        *end = first + count;
+        return;
+    }
+    if (first < *start) *start = first;
+    if (first + count > *end) *end = first + count;
+}
+
+// nanoseconds from some fixed point, thread safe. glfwGetTimerValue returns 0 until glfwInit so tracing cant use it
+static uint64_t goofy_clockNow(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency); // same value on every thread, the race is harmless
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000000ull + (uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000000ull / (uint64_t)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+#endif
+}
+
+// library wide counters, only touched on the GL thread
+static GOOFY_STATS goofy_stats;
+static unsigned int goofy_statsDumpInterval = 0;
+static uint64_t goofy_lastStatsFrame = 0; // goofy_clockNow of the last goofy_endStatsFrame
+
+static void goofy_countUpload(GOOFY_BUFFER* buffer, size_t vertices, size_t indices, size_t bytes) {
+    goofy_stats.frame.verticesUploaded += vertices;
+    goofy_stats.frame.indicesUploaded += indices;
+    goofy_stats.frame.bytesUploaded += bytes;
+    buffer->counters.verticesUploaded += vertices;
+    buffer->counters.indicesUploaded += indices;
+    buffer->counters.bytesUploaded += bytes;
+}
+static void goofy_countMeshes(GOOFY_BUFFER* buffer, size_t meshes) {
+    goofy_stats.frame.meshesSubmitted += meshes;
+    buffer->counters.meshesSubmitted += meshes;
+}
+static void goofy_countDropped(GOOFY_BUFFER* buffer, size_t meshes) {
+    goofy_stats.frame.meshesDropped += meshes;
+    buffer->counters.meshesDropped += meshes;
+}
+static void goofy_countDrawCall(GOOFY_BUFFER* buffer, size_t commands) {
+    goofy_stats.frame.drawCalls++;
+    goofy_stats.frame.multiDrawCommands += commands;
+    buffer->counters.drawCalls++;
+    buffer->counters.multiDrawCommands += commands;
+}
+static void goofy_countBinds(GOOFY_BUFFER* buffer, size_t binds) {
+    goofy_stats.frame.stateBinds += binds;
+    buffer->counters.stateBinds += binds;
+}
+static void goofy_countGrowths(GOOFY_BUFFER* buffer, size_t growths) {
+    goofy_stats.frame.arrayGrowths += growths;
+    if (buffer) buffer->counters.arrayGrowths += growths;
+}
+static uint64_t goofy_statsNow(void) {
+    return goofy_clockNow();
+}
+static void goofy_recordLatency(GOOFY_HISTOGRAM* histogram, uint64_t start) {
+    uint64_t nanoseconds = goofy_clockNow() - start;
+    unsigned int bucket = 0;
+    while (bucket + 1 < GOOFY_HISTOGRAM_BUCKETS && (nanoseconds >> (bucket + 1)) != 0) bucket++;
+    histogram->buckets[bucket]++;
+    histogram->count++;
+    histogram->totalNanoseconds += nanoseconds;
+    if (nanoseconds > histogram->maxNanoseconds) histogram->maxNanoseconds = nanoseconds;
+}
+
+#ifdef GOOFY_TRACE
+#ifndef GOOFY_TRACE_RING_SIZE
+#define GOOFY_TRACE_RING_SIZE 16384 // zones per thread, has to be a power of 2
+#endif
+typedef struct {
+    const char* name;
+    uint64_t start, end; // goofy_clockNow nanoseconds
+} GOOFY_TRACE_EVENT;
+typedef struct GOOFY_TRACE_RING {
+    GOOFY_TRACE_EVENT events[GOOFY_TRACE_RING_SIZE];
+    atomic_size_t head; // only the owning thread writes it, the events before it are complete
+    size_t cleared; // only goofy_clearTrace writes it
+    unsigned int thread;
+    struct GOOFY_TRACE_RING* next;
+} GOOFY_TRACE_RING;
+// every ring ever made, pushed with a compare exchange and only freed by goofy_terminate
+static _Atomic(GOOFY_TRACE_RING*) goofy_traceRings = NULL;
+static atomic_uint goofy_traceThreads = 0;
+static atomic_uint goofy_traceGeneration = 1; // goofy_terminate bumps it so threads dont keep a freed ring
+static _Thread_local GOOFY_TRACE_RING* goofy_threadRing = NULL;
+static _Thread_local unsigned int goofy_threadRingGeneration = 0;
+#endif
+
+// space taken by goofy_renderMeshConcurrent, offsets are relative to the start of the region
+struct GOOFY_SUBMIT_STATE {
+    atomic_size_t vertexOffset;
+    atomic_size_t indexOffset; // 16 bit units
+    atomic_size_t meshCount;
+    atomic_size_t dropped; // meshes that didnt fit, only the first one gets printed
+    char active;
+    size_t vertexStart, indexStart; // the region in the buffer
+    size_t vertexLimit, indexLimit;
+    size_t firstVertex, firstIndex; // what was there before, only the rest gets uploaded
+    unsigned char* vertices; // the mapped region or the cpu staging memory
+    unsigned short* indices;
+    unsigned char* stagingVertices;
+    unsigned short* stagingIndices;
+    size_t stagingVertexSize, stagingIndexSize;
+    GOOFY_BOUNDS* boxes; // packed buffers: the box of every mesh, goofy_endConcurrentSubmit makes their instance records
+    size_t boxCapacity;
+};
+
+// frustum culling compute shader (goofy_drawAllMeshesCulled), made on first use
+static GLuint goofy_cullProgram = 0;
+static int goofy_cullPlanesUniform = -1;
+static int goofy_cullCapacityUniform = -1;
+
+// SHADER-UNIFORM functions
+static uint32_t goofy_hashName(const char* name, size_t length) {
+    uint32_t hash = 2166136261u; // FNV-1a
+    for (size_t i = 0; i < length; ++i) {
+        hash = (hash ^ (unsigned char)name[i]) * 16777619u;
+    }
+    return hash;
+}
+// bytes of one element of a uniform type, 0 for types the setters dont support
+static size_t goofy_uniformTypeSize(GLenum type) {
+    switch (type) {
+        case GL_FLOAT: case GL_INT: case GL_UNSIGNED_INT: case GL_BOOL: return 4;
+        case GL_FLOAT_VEC2: case GL_INT_VEC2: case GL_UNSIGNED_INT_VEC2: case GL_BOOL_VEC2: return 8;
+        case GL_FLOAT_VEC3: case GL_INT_VEC3: case GL_UNSIGNED_INT_VEC3: case GL_BOOL_VEC3: return 12;
+        case GL_FLOAT_VEC4: case GL_INT_VEC4: case GL_UNSIGNED_INT_VEC4: case GL_BOOL_VEC4: case GL_FLOAT_MAT2: return 16;
+        case GL_FLOAT_MAT3: return 36;
+        case GL_FLOAT_MAT4: return 64;
+        default: return 4; // samplers and images are set like ints
+    }
+}
+static void goofy_freeShaderTable(GOOFY_SHADER* shader) {
+    for (int i = 0; i < shader->uniformCount; ++i) {
+        free(shader->uniforms[i].name);
+    }
+    free(shader->uniforms);
+    free(shader->buckets);
+    free(shader->values);
+    free(shader);
+}
+static GOOFY_SHADER* goofy_buildShaderTable(GLuint program) {
+    GOOFY_SHADER* shader = (GOOFY_SHADER*)calloc(1, sizeof(GOOFY_SHADER));
+    if (!shader) return NULL;
+    shader->program = program;
+    shader->textureArrayUniform = -1;
+    bind_uniform_blocks(program); // programs that didnt come from create_shader_program
+
+    GLint activeCount = 0, maxLength = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &activeCount);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    char* name = (char*)malloc(maxLength > 0 ? (size_t)maxLength : 1);
+    shader->uniforms = (GOOFY_UNIFORM*)calloc(activeCount > 0 ? (size_t)activeCount : 1, sizeof(GOOFY_UNIFORM));
+    shader->bucketCount = 16;
+    while (shader->bucketCount < activeCount * 2) shader->bucketCount *= 2;
+    shader->buckets = (int*)malloc(sizeof(int) * shader->bucketCount);
+    if (!name || !shader->uniforms || !shader->buckets) {
+        fprintf(stderr, "[GOOFYLIB3] Failed to allocate uniform table for program %u\n", program);
+        free(name);
+        goofy_freeShaderTable(shader);
+        return NULL;
+    }
+    for (int i = 0; i < shader->bucketCount; ++i) shader->buckets[i] = -1;
+
+    size_t valuesSize = 0;
+    for (GLint i = 0; i < activeCount; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(program, (GLuint)i, maxLength, &length, &size, &type, name);
+        GLint location = glGetUniformLocation(program, name);
+        if (location < 0) continue; // uniform block members dont have locations
+
+        // arrays show up as "name[0]", look them up without the brackets
+        if (length > 3 && strcmp(name + length - 3, "[0]") == 0) {
+            length -= 3;
+            name[length] = '\0';
+        }
+        GOOFY_UNIFORM* uniform = &shader->uniforms[shader->uniformCount];
+        uniform->name = (char*)malloc((size_t)length + 1);
+        if (!uniform->name) continue;
+        memcpy(uniform->name, name, (size_t)length + 1);
+        uniform->hash = goofy_hashName(name, (size_t)length);
+        uniform->location = location;
+        uniform->type = type;
+        uniform->arraySize = size;
+        uniform->valueOffset = valuesSize;
+        uniform->set = 0;
+        valuesSize += goofy_uniformTypeSize(type) * (size_t)size;
+
+        int bucket = (int)(uniform->hash & (uint32_t)(shader->bucketCount - 1));
+        while (shader->buckets[bucket] >= 0) bucket = (bucket + 1) & (shader->bucketCount - 1);
+        shader->buckets[bucket] = shader->uniformCount++;
+    }
+    free(name);
+
+    shader->values = (unsigned char*)calloc(valuesSize ? valuesSize : 1, 1);
+    if (!shader->values) {
+        fprintf(stderr, "[GOOFYLIB3] Failed to allocate uniform values for program %u\n", program);
+        goofy_freeShaderTable(shader);
+        return NULL;
+    }
+    shader->textureArrayUniform = goofy_findUniform(shader, "textureArray");
+    return shader;
+}
+GOOFY_SHADER* goofy_getShader(GLuint program) {
+    static int lastFound = 0; // usually the same program is asked for many times in a row
+    if (lastFound < goofy_shaderRegistryCount && goofy_shaderRegistry[lastFound]->program == program) {
+        return goofy_shaderRegistry[lastFound];
+    }
+    for (int i = 0; i < goofy_shaderRegistryCount; ++i) {
+        if (goofy_shaderRegistry[i]->program == program) {
+            lastFound = i;
+            return goofy_shaderRegistry[i];
+        }
+    }
+    if (program == 0) return NULL;
+
+    if (goofy_shaderRegistryCount >= goofy_shaderRegistryCapacity) {
+        int newCapacity = goofy_shaderRegistryCapacity ? goofy_shaderRegistryCapacity * 2 : 16;
+        GOOFY_SHADER** registry = realloc(goofy_shaderRegistry, sizeof(GOOFY_SHADER*) * newCapacity);
+        if (!registry) {
+            fprintf(stderr, "[GOOFYLIB3] Failed to grow shader registry\n");
+            return NULL;
+        }
+        goofy_shaderRegistry = registry;
+        goofy_shaderRegistryCapacity = newCapacity;
+    }
+    GOOFY_SHADER* shader = goofy_buildShaderTable(program);
+    if (!shader) return NULL;
+    lastFound = goofy_shaderRegistryCount;
+    goofy_shaderRegistry[goofy_shaderRegistryCount++] = shader;
+    return shader;
+}
+void goofy_deleteShader(GLuint program) {
+    for (int i = 0; i < goofy_shaderRegistryCount; ++i) {
+        if (goofy_shaderRegistry[i]->program != program) continue;
+        goofy_freeShaderTable(goofy_shaderRegistry[i]);
+        goofy_shaderRegistry[i] = goofy_shaderRegistry[--goofy_shaderRegistryCount];
+        break;
+    }
+    glDeleteProgram(program);
+}
+int goofy_findUniform(GOOFY_SHADER* shader, const char* name) {
+    if (!shader) return -1;
+    size_t length = strlen(name);
+    uint32_t hash = goofy_hashName(name, length);
+    int bucket = (int)(hash & (uint32_t)(shader->bucketCount - 1));
+    while (shader->buckets[bucket] >= 0) {
+        GOOFY_UNIFORM* uniform = &shader->uniforms[shader->buckets[bucket]];
+        if (uniform->hash == hash && strcmp(uniform->name, name) == 0) return shader->buckets[bucket];
+        bucket = (bucket + 1) & (shader->bucketCount - 1);
+    }
+    return -1;
+}
+// returns 0 when the value is the same as the last one sent
+static char goofy_shadowUniform(GOOFY_SHADER* shader, int index, const void* data, size_t size) {
+    if (!shader || index < 0 || index >= shader->uniformCount) return 0;
+    GOOFY_UNIFORM* uniform = &shader->uniforms[index];
+    size_t capacity = goofy_uniformTypeSize(uniform->type) * (size_t)uniform->arraySize;
+    if (size > capacity) {
+        fprintf(stderr, "[GOOFYLIB3] Too much data for uniform %s\n", uniform->name);
+        return 0;
+    }
+    unsigned char* shadow = shader->values + uniform->valueOffset;
+    if (uniform->set && memcmp(shadow, data, size) == 0) return 0;
+    memcpy(shadow, data, size);
+    uniform->set = 1;
+    return 1;
+}
+// glProgramUniform needs OpenGL 4.1 or ARB_separate_shader_objects. Without it the program gets bound for glUniform and the old one put back
+static void goofy_sendUniform(GLuint program, GLint location, GLenum type, int count, const void* values) {
+    if (GLAD_GL_VERSION_4_1 || GLAD_GL_ARB_separate_shader_objects) {
+        switch (type) {
+            case GL_FLOAT:             glProgramUniform1fv(program, location, count, values); break;
+            case GL_FLOAT_VEC2:        glProgramUniform2fv(program, location, count, values); break;
+            case GL_FLOAT_VEC3:        glProgramUniform3fv(program, location, count, values); break;
+            case GL_FLOAT_VEC4:        glProgramUniform4fv(program, location, count, values); break;
+            case GL_INT_VEC2:          case GL_BOOL_VEC2: glProgramUniform2iv(program, location, count, values); break;
+            case GL_INT_VEC3:          case GL_BOOL_VEC3: glProgramUniform3iv(program, location, count, values); break;
+            case GL_INT_VEC4:          case GL_BOOL_VEC4: glProgramUniform4iv(program, location, count, values); break;
+            case GL_UNSIGNED_INT:      glProgramUniform1uiv(program, location, count, values); break;
+            case GL_UNSIGNED_INT_VEC2: glProgramUniform2uiv(program, location, count, values); break;
+            case GL_UNSIGNED_INT_VEC3: glProgramUniform3uiv(program, location, count, values); break;
+            case GL_UNSIGNED_INT_VEC4: glProgramUniform4uiv(program, location, count, values); break;
+            case GL_FLOAT_MAT2:        glProgramUniformMatrix2fv(program, location, count, GL_FALSE, values); break;
+            case GL_FLOAT_MAT3:        glProgramUniformMatrix3fv(program, location, count, GL_FALSE, values); break;
+            case GL_FLOAT_MAT4:        glProgramUniformMatrix4fv(program, location, count, GL_FALSE, values); break;
+            default:                   glProgramUniform1iv(program, location, count, values); break; // int, bool, samplers
+        }
+        return;
+    }
+    GLint previous = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &previous);
+    if ((GLuint)previous != program) glUseProgram(program);
+    switch (type) {
+        case GL_FLOAT:             glUniform1fv(location, count, values); break;
+        case GL_FLOAT_VEC2:        glUniform2fv(location, count, values); break;
+        case GL_FLOAT_VEC3:        glUniform3fv(location, count, values); break;
+        case GL_FLOAT_VEC4:        glUniform4fv(location, count, values); break;
+        case GL_INT_VEC2:          case GL_BOOL_VEC2: glUniform2iv(location, count, values); break;
+        case GL_INT_VEC3:          case GL_BOOL_VEC3: glUniform3iv(location, count, values); break;
+        case GL_INT_VEC4:          case GL_BOOL_VEC4: glUniform4iv(location, count, values); break;
+        case GL_UNSIGNED_INT:      glUniform1uiv(location, count, values); break;
+        case GL_UNSIGNED_INT_VEC2: glUniform2uiv(location, count, values); break;
+        case GL_UNSIGNED_INT_VEC3: glUniform3uiv(location, count, values); break;
+        case GL_UNSIGNED_INT_VEC4: glUniform4uiv(location, count, values); break;
+        case GL_FLOAT_MAT2:        glUniformMatrix2fv(location, count, GL_FALSE, values); break;
+        case GL_FLOAT_MAT3:        glUniformMatrix3fv(location, count, GL_FALSE, values); break;
+        case GL_FLOAT_MAT4:        glUniformMatrix4fv(location, count, GL_FALSE, values); break;
+        default:                   glUniform1iv(location, count, values); break;
+    }
+    if ((GLuint)previous != program) glUseProgram((GLuint)previous);
+}
+void goofy_setUniformInt(GOOFY_SHADER* shader, int uniform, int value) {
+    if (!goofy_shadowUniform(shader, uniform, &value, sizeof(value))) return;
+    goofy_sendUniform(shader->program, shader->uniforms[uniform].location, GL_INT, 1, &value);
+}
+void goofy_setUniformFloat(GOOFY_SHADER* shader, int uniform, float value) {
+    if (!goofy_shadowUniform(shader, uniform, &value, sizeof(value))) return;
+    goofy_sendUniform(shader->program, shader->uniforms[uniform].location, GL_FLOAT, 1, &value);
+}
+void goofy_setUniformVec2(GOOFY_SHADER* shader, int uniform, const float* values) {
+    if (!goofy_shadowUniform(shader, uniform, values, sizeof(float) * 2)) return;
+    goofy_sendUniform(shader->program, shader->uniforms[uniform].location, GL_FLOAT_VEC2, 1, values);
+}
+void goofy_setUniformVec3(GOOFY_SHADER* shader, int uniform, const float* values) {
+    if (!goofy_shadowUniform(shader, uniform, values, sizeof(float) * 3)) return;
+    goofy_sendUniform(shader->program, shader->uniforms[uniform].location, GL_FLOAT_VEC3, 1, values);
+}
+void goofy_setUniformVec4(GOOFY_SHADER* shader, int uniform, const float* values) {
+    if (!goofy_shadowUniform(shader, uniform, values, sizeof(float) * 4)) return;
+    goofy_sendUniform(shader->program, shader->uniforms[uniform].location, GL_FLOAT_VEC4, 1, values);
+}
+void goofy_setUniformMat4(GOOFY_SHADER* shader, int uniform, const float* matrix) {
+    if (!goofy_shadowUniform(shader, uniform, matrix, sizeof(float) * 16)) return;
+    goofy_sendUniform(shader->program, shader->uniforms[uniform].location, GL_FLOAT_MAT4, 1, matrix);
+}
+void goofy_setUniformArray(GOOFY_SHADER* shader, int uniform, const void* values, int count) {
+    if (!shader || uniform < 0 || uniform >= shader->uniformCount) return;
+    GOOFY_UNIFORM* info = &shader->uniforms[uniform];
+    if (!goofy_shadowUniform(shader, uniform, values, goofy_uniformTypeSize(info->type) * (size_t)count)) return;
+    goofy_sendUniform(shader->program, info->location, info->type, count, values);
+}
+// the texture array always goes on unit 0, with the shadow value this only reaches the driver once per program
+static void goofy_setTextureUnit(GLuint program) {
+    GOOFY_SHADER* shader = goofy_getShader(program);
+    if (shader && shader->textureArrayUniform >= 0) goofy_setUniformInt(shader, shader->textureArrayUniform, 0);
+}
+
 // skibidi Functions
 void APIENTRY glDebugOutput(GLenum source,GLenum type, unsigned int id,GLenum severity,GLsizei length,const char *message,const void *userParam){
     // ignore non-significant error/warning codes
@@ -63,388 +485,3199 @@ void APIENTRY glDebugOutput(GLenum source,GLenum type, unsigned int id,GLenum se
     case GL_DEBUG_TYPE_OTHER:               printf("Type: Other\n"); break;
     }
 
-    switch (severity)
-    {
-    case GL_DEBUG_SEVERITY_HIGH:         printf("Severity: high\n"); break;
-    case GL_DEBUG_SEVERITY_MEDIUM:       printf("Severity: medium\n"); break;
-    case GL_DEBUG_SEVERITY_LOW:          printf("Severity: low\n"); break;
-    case GL_DEBUG_SEVERITY_NOTIFICATION: printf("Severity: notification\n"); break;
+    switch (severity)
+    {
+    case GL_DEBUG_SEVERITY_HIGH:         printf("Severity: high\n"); break;
+    case GL_DEBUG_SEVERITY_MEDIUM:       printf("Severity: medium\n"); break;
+    case GL_DEBUG_SEVERITY_LOW:          printf("Severity: low\n"); break;
+    case GL_DEBUG_SEVERITY_NOTIFICATION: printf("Severity: notification\n"); break;
+    }
+
+    printf("\n");
+}
+void error_callback(int error, const char* description){
+    fprintf(stderr, "[GOOFYLIB3] ERROR : %s\n", description);
+}
+void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
+    glfwMakeContextCurrent(window); // 👈 Ensure the correct context
+    glViewport(0, 0, width, height);
+}
+
+
+// MAIN MODULE
+GLFWwindow* goofy_initWindow(const char* windowName, int width, int height, int major_version, int minor_version) {
+    glfwSetErrorCallback(error_callback);
+    printf("[GOOFYLIB3] Initializing window %s\n",windowName); 
+    if (!glfwInit()) {
+        printf("[GOOFYLIB3] Failed to initialize GLFW for window %s\n",windowName);
+        return NULL; 
+    } else {
+        printf("[GOOFYLIB3] Succesfully initialized GLFW for window %s\n",windowName); 
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, major_version);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, minor_version);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_FALSE);  
+    
+    // WINDOW MAKE
+    GLFWwindow* window = glfwCreateWindow(width, height, windowName, NULL, NULL);
+    if (!window) {
+        printf("[GOOFYLIB3] Failed to create a window for window %s\n",windowName);
+        glfwTerminate();
+        return NULL;
+    } else {
+        printf("[GOOFYLIB3] Succesfully initialized a window for window %s\n",windowName); 
+    }
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        printf("[GOOFYLIB3] Failed to initialize GLAD for window %s\n",windowName);
+        glfwDestroyWindow(window);  
+        glfwTerminate();
+        return NULL;  
+    } else {
+        printf("[GOOFYLIB3] Succesfully initialized GLAD for window %s\n",windowName); 
+    }
+
+    glViewport(0, 0, width, height);
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    GLint flags;
+    glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+    if (flags & GL_CONTEXT_FLAG_DEBUG_BIT)
+    {
+        glEnable(GL_DEBUG_OUTPUT);
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS); 
+        glDebugMessageCallback(glDebugOutput, NULL);
+        glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, NULL, GL_TRUE);
+    } 
+    printf("[GOOFYLIB3] Succesfully made window %s\n",windowName); 
+    return window;
+}
+GLFWwindow* goofy_initHeadless(int width, int height, int major_version, int minor_version) {
+    glfwSetErrorCallback(error_callback);
+#if GLFW_VERSION_MAJOR > 3 || (GLFW_VERSION_MAJOR == 3 && GLFW_VERSION_MINOR >= 4)
+    // the null platform doesnt need X11 or wayland
+    if (glfwPlatformSupported(GLFW_PLATFORM_NULL)) glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#endif
+    if (!glfwInit()) {
+        printf("[GOOFYLIB3] Failed to initialize GLFW for headless context\n");
+        return NULL;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, major_version);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, minor_version);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_FALSE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#if GLFW_VERSION_MAJOR > 3 || (GLFW_VERSION_MAJOR == 3 && GLFW_VERSION_MINOR >= 4)
+    glfwWindowHint(GLFW_CONTEXT_CREATION_API, glfwGetPlatform() == GLFW_PLATFORM_NULL ? GLFW_OSMESA_CONTEXT_API : GLFW_EGL_CONTEXT_API);
+#endif
+
+    GLFWwindow* window = glfwCreateWindow(width, height, "goofyLib3 headless", NULL, NULL);
+    if (!window) {
+        printf("[GOOFYLIB3] Failed to create headless context\n");
+        glfwTerminate();
+        return NULL;
+    }
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        printf("[GOOFYLIB3] Failed to initialize GLAD for headless context\n");
+        glfwDestroyWindow(window);
+        glfwTerminate();
+        return NULL;
+    }
+    glfwSwapInterval(0); // frame times shouldnt wait for vsync
+    glViewport(0, 0, width, height);
+    printf("[GOOFYLIB3] Succesfully made headless context (%s)\n", (const char*)glGetString(GL_RENDERER));
+    return window;
+}
+GLuint goofy_initShaders(const char* vertexPath,const char* fragmentPath) {
+    GLuint shaderProgram = create_shader_program(vertexPath,fragmentPath);
+    if (shaderProgram == 0) {
+        printf("Failed to create shader program\n");
+        exit(1);
+    }
+    goofy_getShader(shaderProgram); // builds the uniform table now instead of on the first draw
+    return shaderProgram;
+}
+static char goofy_hasGLVersion(int major, int minor) {
+    GLint currentMajor = 0, currentMinor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &currentMajor);
+    glGetIntegerv(GL_MINOR_VERSION, &currentMinor);
+    return currentMajor > major || (currentMajor == major && currentMinor >= minor);
+}
+// VERTEX LAYOUTS
+static unsigned short goofy_floatToHalf(float value) {
+    union { float f; uint32_t u; } bits = { value };
+    uint32_t sign = (bits.u >> 16) & 0x8000;
+    int32_t exponent = (int32_t)((bits.u >> 23) & 0xff) - 127 + 15;
+    uint32_t mantissa = bits.u & 0x7fffff;
+
+    if (((bits.u >> 23) & 0xff) == 0xff) return (unsigned short)(sign | 0x7c00 | (mantissa ? 0x200 : 0)); // inf/nan
+    if (exponent >= 31) return (unsigned short)(sign | 0x7c00); // too big
+    if (exponent <= 0) {
+        if (exponent < -10) return (unsigned short)sign; // too small, zero
+        mantissa |= 0x800000;
+        uint32_t shift = (uint32_t)(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        if ((mantissa >> (shift - 1)) & 1) half++; // round
+        return (unsigned short)(sign | half);
+    }
+    uint32_t half = sign | ((uint32_t)exponent << 10) | (mantissa >> 13);
+    if (mantissa & 0x1000) half++; // round, carries into the exponent when needed
+    return (unsigned short)half;
+}
+static unsigned int goofy_packSnorm10(float value) {
+    if (value > 1.0f) value = 1.0f;
+    if (value < -1.0f) value = -1.0f;
+    int packed = (int)lroundf(value * 511.0f);
+    return (unsigned int)packed & 0x3ff;
+}
+static unsigned char goofy_packUnorm8(float value) {
+    if (value > 1.0f) value = 1.0f;
+    if (value < 0.0f) value = 0.0f;
+    return (unsigned char)lroundf(value * 255.0f);
+}
+static unsigned short goofy_packUnorm16(float value) {
+    if (value > 1.0f) value = 1.0f;
+    if (!(value > 0.0f)) value = 0.0f; // nan too
+    return (unsigned short)lroundf(value * 65535.0f);
+}
+static size_t goofy_typeSize(GLenum type) {
+    switch (type) {
+        case GL_BYTE: case GL_UNSIGNED_BYTE: return 1;
+        case GL_SHORT: case GL_UNSIGNED_SHORT: case GL_HALF_FLOAT: return 2;
+        default: return 4;
+    }
+}
+GOOFY_VERTEX_LAYOUT goofy_initLayout(void) {
+    GOOFY_VERTEX_LAYOUT layout;
+    memset(&layout, 0, sizeof(layout));
+    return layout;
+}
+void goofy_addLayoutAttribute(GOOFY_VERTEX_LAYOUT* layout, GLuint location, GOOFY_ATTRIBUTE_SOURCE source, GLenum type, GLint components, GLboolean normalized, char integer) {
+    if (layout->attributeCount >= GOOFY_MAX_ATTRIBUTES) {
+        fprintf(stderr, "[GOOFYLIB3] Vertex layout is full, attribute %u not added\n", location);
+        return;
+    }
+    if (location >= GOOFY_INSTANCE_LOCATION && location < GOOFY_INSTANCE_LOCATION + GOOFY_INSTANCE_ATTRIBUTES) {
+        // the instance attributes would overwrite it in goofy_createBuffer
+        fprintf(stderr, "[GOOFYLIB3] Location %u is used by the instance attributes (%d-%d), attribute not added\n",
+                location, GOOFY_INSTANCE_LOCATION, GOOFY_INSTANCE_LOCATION + GOOFY_INSTANCE_ATTRIBUTES - 1);
+        return;
+    }
+    size_t size = type == GL_INT_2_10_10_10_REV ? 4 : goofy_typeSize(type) * components;
+    GOOFY_VERTEX_ATTRIBUTE* attribute = &layout->attributes[layout->attributeCount++];
+    attribute->location = location;
+    attribute->source = source;
+    attribute->type = type;
+    attribute->components = components;
+    attribute->normalized = normalized;
+    attribute->integer = integer;
+    attribute->offset = layout->stride;
+    layout->stride = (layout->stride + size + 3) & ~(size_t)3; // keep attributes 4 byte aligned
+}
+GOOFY_VERTEX_LAYOUT goofy_fullLayout(void) {
+    GOOFY_VERTEX_LAYOUT layout = goofy_initLayout();
+    goofy_addLayoutAttribute(&layout, 0, GOOFY_ATTRIBUTE_POSITION, GL_FLOAT, 3, GL_FALSE, 0);
+    goofy_addLayoutAttribute(&layout, 1, GOOFY_ATTRIBUTE_COLOR, GL_FLOAT, 3, GL_FALSE, 0);
+    goofy_addLayoutAttribute(&layout, 2, GOOFY_ATTRIBUTE_NORMAL, GL_FLOAT, 3, GL_FALSE, 0);
+    goofy_addLayoutAttribute(&layout, 3, GOOFY_ATTRIBUTE_TEXCOORD, GL_FLOAT, 2, GL_FALSE, 0);
+    goofy_addLayoutAttribute(&layout, 4, GOOFY_ATTRIBUTE_TEXINDEX, GL_INT, 1, GL_FALSE, 1);
+    goofy_addLayoutAttribute(&layout, 5, GOOFY_ATTRIBUTE_IS3D, GL_UNSIGNED_INT, 1, GL_FALSE, 1);
+    return layout;
+}
+GOOFY_VERTEX_LAYOUT goofy_packedLayout(void) {
+    // built by hand because is3d shares the 4th color byte
+    GOOFY_VERTEX_LAYOUT layout = goofy_initLayout();
+    GOOFY_VERTEX_ATTRIBUTE attributes[] = {
+        {0, GOOFY_ATTRIBUTE_POSITION, GL_UNSIGNED_SHORT, 3, GL_TRUE, 0, offsetof(GOOFY_PACKED_VERTICE, position)},
+        {1, GOOFY_ATTRIBUTE_COLOR, GL_UNSIGNED_BYTE, 3, GL_TRUE, 0, offsetof(GOOFY_PACKED_VERTICE, colors)},
+        {2, GOOFY_ATTRIBUTE_NORMAL, GL_INT_2_10_10_10_REV, 4, GL_TRUE, 0, offsetof(GOOFY_PACKED_VERTICE, normal)},
+        {3, GOOFY_ATTRIBUTE_TEXCOORD, GL_HALF_FLOAT, 2, GL_FALSE, 0, offsetof(GOOFY_PACKED_VERTICE, texCoords)},
+        {4, GOOFY_ATTRIBUTE_TEXINDEX, GL_SHORT, 1, GL_FALSE, 1, offsetof(GOOFY_PACKED_VERTICE, texIndex)},
+        {5, GOOFY_ATTRIBUTE_IS3D, GL_UNSIGNED_BYTE, 1, GL_FALSE, 1, offsetof(GOOFY_PACKED_VERTICE, colors) + 3},
+    };
+    layout.attributeCount = sizeof(attributes) / sizeof(attributes[0]);
+    memcpy(layout.attributes, attributes, sizeof(attributes));
+    layout.stride = sizeof(GOOFY_PACKED_VERTICE);
+    return layout;
+}
+static char goofy_sameLayout(const GOOFY_VERTEX_LAYOUT* a, const GOOFY_VERTEX_LAYOUT* b) {
+    if (a->attributeCount != b->attributeCount || a->stride != b->stride) return 0;
+    for (int i = 0; i < a->attributeCount; ++i) {
+        const GOOFY_VERTEX_ATTRIBUTE* x = &a->attributes[i];
+        const GOOFY_VERTEX_ATTRIBUTE* y = &b->attributes[i];
+        if (x->location != y->location || x->source != y->source || x->type != y->type || x->components != y->components ||
+            x->normalized != y->normalized || x->integer != y->integer || x->offset != y->offset) return 0;
+    }
+    return 1;
+}
+// the full and packed layouts get fast paths when uploading
+static GOOFY_VERTEX_FORMAT goofy_layoutFormat(const GOOFY_VERTEX_LAYOUT* layout) {
+    GOOFY_VERTEX_LAYOUT full = goofy_fullLayout();
+    GOOFY_VERTEX_LAYOUT packed = goofy_packedLayout();
+    if (goofy_sameLayout(layout, &full)) return GOOFY_VERTEX_FULL;
+    if (goofy_sameLayout(layout, &packed)) return GOOFY_VERTEX_PACKED;
+    return GOOFY_VERTEX_CUSTOM;
+}
+static int goofy_attributeValues(const GOOFY_VERTICE* v, GOOFY_ATTRIBUTE_SOURCE source, float* values) {
+    switch (source) {
+        case GOOFY_ATTRIBUTE_POSITION: memcpy(values, v->position, sizeof(float) * 3); return 3;
+        case GOOFY_ATTRIBUTE_COLOR:    memcpy(values, v->colors, sizeof(float) * 3); return 3;
+        case GOOFY_ATTRIBUTE_NORMAL:   memcpy(values, v->normals, sizeof(float) * 3); return 3;
+        case GOOFY_ATTRIBUTE_TEXCOORD: memcpy(values, v->texCoords, sizeof(float) * 2); return 2;
+        case GOOFY_ATTRIBUTE_TEXINDEX: values[0] = (float)v->texIndex; return 1;
+        case GOOFY_ATTRIBUTE_IS3D:     values[0] = (float)v->is3d; return 1;
+    }
+    return 0;
+}
+static float goofy_clampf(float value, float low, float high) {
+    return value < low ? low : (value > high ? high : value);
+}
+void goofy_convertVertices(const GOOFY_VERTEX_LAYOUT* layout, const GOOFY_VERTICE* vertices, void* converted, size_t count) {
+    unsigned char* dst = (unsigned char*)converted;
+    for (size_t i = 0; i < count; ++i, dst += layout->stride) {
+        for (int a = 0; a < layout->attributeCount; ++a) {
+            const GOOFY_VERTEX_ATTRIBUTE* attribute = &layout->attributes[a];
+            float values[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+            goofy_attributeValues(&vertices[i], attribute->source, values);
+            unsigned char* out = dst + attribute->offset;
+            char norm = attribute->normalized && !attribute->integer;
+
+            if (attribute->type == GL_INT_2_10_10_10_REV) {
+                unsigned int packed = goofy_packSnorm10(values[0]) | (goofy_packSnorm10(values[1]) << 10) | (goofy_packSnorm10(values[2]) << 20);
+                memcpy(out, &packed, sizeof(packed));
+                continue;
+            }
+            for (int c = 0; c < attribute->components; ++c) {
+                float value = values[c];
+                switch (attribute->type) {
+                    case GL_FLOAT:          memcpy(out + c * 4, &value, 4); break;
+                    case GL_HALF_FLOAT:     { unsigned short h = goofy_floatToHalf(value); memcpy(out + c * 2, &h, 2); } break;
+                    case GL_UNSIGNED_BYTE:  out[c] = norm ? goofy_packUnorm8(value) : (unsigned char)value; break;
+                    case GL_BYTE:           out[c] = (unsigned char)(signed char)(norm ? lroundf(goofy_clampf(value, -1.0f, 1.0f) * 127.0f) : value); break;
+                    case GL_UNSIGNED_SHORT: { unsigned short x = norm ? (unsigned short)lroundf(goofy_clampf(value, 0.0f, 1.0f) * 65535.0f) : (unsigned short)value; memcpy(out + c * 2, &x, 2); } break;
+                    case GL_SHORT:          { short x = norm ? (short)lroundf(goofy_clampf(value, -1.0f, 1.0f) * 32767.0f) : (short)value; memcpy(out + c * 2, &x, 2); } break;
+                    case GL_UNSIGNED_INT:   { unsigned int x = (unsigned int)value; memcpy(out + c * 4, &x, 4); } break;
+                    case GL_INT:            { int x = (int)value; memcpy(out + c * 4, &x, 4); } break;
+                    default: break;
+                }
+            }
+        }
+    }
+}
+// creates the VBO and EBO for the current sizes and leaves them bound
+static void goofy_allocStorage(GOOFY_BUFFER* buffer) {
+    // ring buffers get immutable storage that stays mapped for the whole lifetime of the buffer
+    GLbitfield persistentFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    GLsizeiptr vboSize = (GLsizeiptr)buffer->maxVertices * buffer->frameCount * buffer->vertexSize;
+    GLsizeiptr eboSize = (GLsizeiptr)buffer->maxIndices * buffer->frameCount * GOOFY_INDEX_UNIT;
+
+    glGenBuffers(1, &buffer->VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer->VBO);
+    if (buffer->VBO == 0) {
+        printf("[GOOFYLIB3] Failed to generate VBO\n");
+    } else if (buffer->frameCount > 1) {
+        printf("[GOOFYLIB3] Allocating persistent VBO with size: %zu (%u regions)\n", (size_t)vboSize, buffer->frameCount);
+        glBufferStorage(GL_ARRAY_BUFFER, vboSize, NULL, persistentFlags);
+        buffer->mappedVertices = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, vboSize, persistentFlags);
+        printf("[GOOFYLIB3] Successfully initialized VBO\n");
+    } else {
+        printf("[GOOFYLIB3] Allocating VBO with size: %zu\n", buffer->maxVertices * buffer->vertexSize);
+        glBufferData(GL_ARRAY_BUFFER, buffer->maxVertices * buffer->vertexSize, NULL, GL_DYNAMIC_DRAW);
+        printf("[GOOFYLIB3] Successfully initialized VBO\n");
+    }
+
+    glGenBuffers(1, &buffer->EBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer->EBO);
+    if (buffer->EBO == 0) {
+        printf("[GOOFYLIB3] Failed to generate EBO.\n");
+    } else if (buffer->frameCount > 1) {
+        glBufferStorage(GL_ELEMENT_ARRAY_BUFFER, eboSize, NULL, persistentFlags);
+        buffer->mappedIndices = (unsigned short*)glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0, eboSize, persistentFlags);
+        printf("[GOOFYLIB3] Successfully initialized EBO\n");
+    } else {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, GOOFY_INDEX_UNIT * buffer->maxIndices, NULL, GL_DYNAMIC_DRAW);
+        printf("[GOOFYLIB3] Successfully initialized EBO\n");
+    }
+
+    if (buffer->frameCount > 1 && (!buffer->mappedVertices || !buffer->mappedIndices)) {
+        printf("[GOOFYLIB3] Failed to map ring buffer\n");
+    }
+}
+static void goofy_setVertexAttributes(GOOFY_BUFFER* buffer) {
+    for (int i = 0; i < buffer->layout.attributeCount; ++i) {
+        GOOFY_VERTEX_ATTRIBUTE* attribute = &buffer->layout.attributes[i];
+        if (attribute->integer) {
+            glVertexAttribIPointer(attribute->location, attribute->components, attribute->type, (GLsizei)buffer->layout.stride, (void*)attribute->offset);
+        } else {
+            glVertexAttribPointer(attribute->location, attribute->components, attribute->type, attribute->normalized, (GLsizei)buffer->layout.stride, (void*)attribute->offset);
+        }
+        glEnableVertexAttribArray(attribute->location);
+    }
+}
+// one draw data entry per slot, the gpu copy is a shader storage buffer with the slot count in front
+static char goofy_reserveDrawData(GOOFY_BUFFER* buffer, size_t capacity) {
+    if (capacity <= buffer->drawDataCapacity) return 1;
+    GOOFY_INSTANCE* drawData = realloc(buffer->drawData, sizeof(GOOFY_INSTANCE) * capacity);
+    if (!drawData) {
+        fprintf(stderr, "[GOOFYLIB3] Failed to allocate slot draw data\n");
+        return 0;
+    }
+    buffer->drawData = drawData;
+    goofy_countGrowths(buffer, 1);
+    buffer->drawDataCapacity = capacity;
+    if (buffer->drawDataBuffer == 0) {
+        if (!goofy_hasGLVersion(4, 3)) return 1; // shaders cant read it without OpenGL 4.3, keep it on the cpu only
+        glGenBuffers(1, &buffer->drawDataBuffer);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer->drawDataBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, GOOFY_DRAW_DATA_HEADER + sizeof(GOOFY_INSTANCE) * capacity, NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    // new storage, everything has to go up again
+    buffer->drawDataDirtyStart = 0;
+    buffer->drawDataDirtyEnd = buffer->slotCount;
+    buffer->drawDataSlotCount = (size_t)-1;
+    return 1;
+}
+static void goofy_markSlotDrawData(GOOFY_BUFFER* buffer, size_t slot) {
+    if (slot < buffer->drawDataDirtyStart) buffer->drawDataDirtyStart = slot;
+    if (slot + 1 > buffer->drawDataDirtyEnd) buffer->drawDataDirtyEnd = slot + 1;
+}
+// uploads the changed slot draw data and binds it for the draws of this buffer
+static void goofy_bindDrawData(GOOFY_BUFFER* buffer) {
+    if (buffer->drawDataBuffer == 0) return;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer->drawDataBuffer);
+    if (buffer->drawDataSlotCount != buffer->slotCount) {
+        GLuint slotCount = (GLuint)buffer->slotCount;
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(slotCount), &slotCount);
+        buffer->drawDataSlotCount = buffer->slotCount;
+    }
+    if (buffer->drawDataDirtyEnd > buffer->slotCount) buffer->drawDataDirtyEnd = buffer->slotCount;
+    if (buffer->drawDataDirtyStart < buffer->drawDataDirtyEnd) {
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, GOOFY_DRAW_DATA_HEADER + sizeof(GOOFY_INSTANCE) * buffer->drawDataDirtyStart,
+                        sizeof(GOOFY_INSTANCE) * (buffer->drawDataDirtyEnd - buffer->drawDataDirtyStart),
+                        buffer->drawData + buffer->drawDataDirtyStart);
+        goofy_countUpload(buffer, 0, 0, sizeof(GOOFY_INSTANCE) * (buffer->drawDataDirtyEnd - buffer->drawDataDirtyStart));
+    }
+    buffer->drawDataDirtyStart = (size_t)-1;
+    buffer->drawDataDirtyEnd = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, GOOFY_DRAW_BINDING, buffer->drawDataBuffer);
+}
+// points the instance attributes (instance VBO has to be bound) at firstInstance. Without base instance draws (OpenGL 4.2)
+// instanced meshes get drawn with the attributes moved to their first instance and then put back to 0
+static void goofy_pointInstanceAttributes(size_t firstInstance) {
+    size_t base = sizeof(GOOFY_INSTANCE) * firstInstance;
+    for (int column = 0; column < 4; ++column) {
+        glVertexAttribPointer(GOOFY_INSTANCE_LOCATION + column, 4, GL_FLOAT, GL_FALSE, sizeof(GOOFY_INSTANCE), (void*)(base + offsetof(GOOFY_INSTANCE, transform) + sizeof(float) * 4 * column));
+    }
+    glVertexAttribPointer(GOOFY_INSTANCE_LOCATION + 4, 3, GL_FLOAT, GL_FALSE, sizeof(GOOFY_INSTANCE), (void*)(base + offsetof(GOOFY_INSTANCE, tint)));
+    glVertexAttribIPointer(GOOFY_INSTANCE_LOCATION + 5, 1, GL_INT, sizeof(GOOFY_INSTANCE), (void*)(base + offsetof(GOOFY_INSTANCE, texIndex)));
+    glVertexAttribPointer(GOOFY_INSTANCE_LOCATION + 6, 3, GL_FLOAT, GL_FALSE, sizeof(GOOFY_INSTANCE), (void*)(base + offsetof(GOOFY_INSTANCE, positionScale)));
+    glVertexAttribPointer(GOOFY_INSTANCE_LOCATION + 7, 3, GL_FLOAT, GL_FALSE, sizeof(GOOFY_INSTANCE), (void*)(base + offsetof(GOOFY_INSTANCE, positionOffset)));
+}
+static GOOFY_BUFFER goofy_createBuffer(GLuint maxVertices, GLuint maxIndices, size_t maxMeshes, unsigned int frameCount, const GOOFY_VERTEX_LAYOUT* layout) {
+    GOOFY_BUFFER buffer;
+    buffer.layout = *layout;
+    buffer.vertexFormat = goofy_layoutFormat(layout);
+    buffer.vertexSize = layout->stride;
+    buffer.scratch = NULL;
+    buffer.scratchSize = 0;
+    buffer.MAX_MESHES = maxMeshes;
+    buffer.meshCount = 0;
+    buffer.currentVerticeOffset = 0;
+    buffer.currentIndiceOffset = 0;
+    buffer.maxVertices = maxVertices;
+    buffer.maxIndices = (size_t)maxIndices * 2; // room for maxIndices 32 bit indices
+    buffer.vertexCeiling = (size_t)-1;
+    buffer.indexCeiling = (size_t)-1;
+    buffer.meshCeiling = (size_t)-1;
+    buffer.frameCount = frameCount;
+    buffer.currentFrame = 0;
+    buffer.frameReady = 0;
+    buffer.fences = NULL;
+    buffer.mappedVertices = NULL;
+    buffer.mappedIndices = NULL;
+    buffer.lastIndices = NULL;
+    buffer.lastIndexCount = 0;
+    buffer.lastIndexOffset = 0;
+    buffer.lastIndexType = GL_UNSIGNED_INT;
+    buffer.slots = NULL;
+    buffer.slotCount = 0;
+    buffer.slotCapacity = 0;
+    buffer.drawCounts = NULL;
+    buffer.drawIndexOffsets = NULL;
+    buffer.drawBaseVertices = NULL;
+    buffer.drawCapacity = 0;
+    buffer.indirectBuffer = 0;
+    buffer.commands = NULL;
+    buffer.commandCapacity = 0;
+    buffer.commandDirtyStart = (size_t)-1;
+    buffer.commandDirtyEnd = 0;
+    buffer.retainedVertexBase = (size_t)maxVertices * frameCount;
+    buffer.retainedIndexBase = buffer.maxIndices * frameCount;
+    buffer.drawDataBuffer = 0;
+    buffer.drawData = NULL;
+    buffer.drawDataCapacity = 0;
+    buffer.drawDataDirtyStart = (size_t)-1;
+    buffer.drawDataDirtyEnd = 0;
+    buffer.drawDataSlotCount = (size_t)-1;
+    buffer.boundsBuffer = 0;
+    buffer.culledCommandBuffer = 0;
+    buffer.culledDrawBuffer = 0;
+    buffer.culledCapacity = 0;
+    buffer.culledRegionSize = 0;
+    buffer.concurrent = NULL;
+    memset(&buffer.counters, 0, sizeof(buffer.counters));
+
+    // alloc arrays
+    buffer.vertexOffsets = (size_t*)malloc(sizeof(size_t) * maxMeshes);
+    buffer.indexOffsets = (size_t*)malloc(sizeof(size_t) * maxMeshes);
+    buffer.vertexCounts = (size_t*)malloc(sizeof(size_t) * maxMeshes);
+    buffer.indexCounts = (size_t*)malloc(sizeof(size_t) * maxMeshes);
+    buffer.indexTypes = (GLenum*)malloc(sizeof(GLenum) * maxMeshes);
+    buffer.instanceCounts = (GLuint*)malloc(sizeof(GLuint) * maxMeshes);
+    buffer.baseInstances = (GLuint*)malloc(sizeof(GLuint) * maxMeshes);
+    printf("[GOOFYLIB3] Succesfully allocated buffers\n");
+    if (!buffer.vertexOffsets || !buffer.indexOffsets || !buffer.vertexCounts || !buffer.indexCounts || !buffer.indexTypes || !buffer.instanceCounts || !buffer.baseInstances) {
+        printf("[GOOFYLIB3] Failed to allocate memory for mesh data arrays\n");
+    }
+
+    glGenVertexArrays(1, &buffer.VAO);
+    glBindVertexArray(buffer.VAO);
+    if (buffer.VAO == 0) {
+        printf("[GOOFYLIB3] Failed to generate VAO\n");
+    } else {
+        printf("[GOOFYLIB3] Successfully initialized VAO\n");
+    }
+
+    goofy_allocStorage(&buffer);
+    if (frameCount > 1) {
+        buffer.fences = (GLsync*)calloc(frameCount, sizeof(GLsync));
+        if (!buffer.fences) {
+            printf("[GOOFYLIB3] Failed to allocate ring buffer fences\n");
+        }
+    }
+    goofy_setVertexAttributes(&buffer);
+
+    // per instance data, instance 0 is always the identity so normal meshes draw like before
+    buffer.instanceCapacity = 256;
+    buffer.instanceCount = 1;
+    buffer.instances = (GOOFY_INSTANCE*)malloc(sizeof(GOOFY_INSTANCE) * buffer.instanceCapacity);
+    if (!buffer.instances) {
+        printf("[GOOFYLIB3] Failed to allocate instance data\n");
+    } else {
+        buffer.instances[0] = goofy_translationInstance(0.0f, 0.0f, 0.0f);
+    }
+    glGenBuffers(1, &buffer.instanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer.instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(GOOFY_INSTANCE) * buffer.instanceCapacity, NULL, GL_DYNAMIC_DRAW);
+    if (buffer.instances) glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(GOOFY_INSTANCE), buffer.instances);
+
+    goofy_pointInstanceAttributes(0);
+    for (int location = 0; location < GOOFY_INSTANCE_ATTRIBUTES; ++location) {
+        glVertexAttribDivisor(GOOFY_INSTANCE_LOCATION + location, 1);
+        glEnableVertexAttribArray(GOOFY_INSTANCE_LOCATION + location);
+    }
+
+    printf("[GOOFYLIB3] Initialized all vertex attributes for VAO\n");
+
+    glBindVertexArray(0);
+
+    // made even without slots, otherwise the shader would see the draw data of whatever buffer was bound before
+    goofy_reserveDrawData(&buffer, 64);
+
+    return buffer;
+}
+// waits until the gpu is done reading the region we are about to write into
+static void goofy_waitFrame(GOOFY_BUFFER* buffer) {
+    GLsync fence = buffer->fences[buffer->currentFrame];
+    if (fence) {
+        GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        while (result == GL_TIMEOUT_EXPIRED) {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        }
+        if (result == GL_WAIT_FAILED) {
+            printf("[GOOFYLIB3] Failed to wait for ring buffer region %u\n", buffer->currentFrame);
+        }
+        glDeleteSync(fence);
+        buffer->fences[buffer->currentFrame] = NULL;
+    }
+    buffer->frameReady = 1;
+}
+GOOFY_BUFFER goofy_initBufferLayout(GLuint maxVertices, GLuint maxIndices, size_t maxMeshes, unsigned int frameCount, const GOOFY_VERTEX_LAYOUT* layout) {
+    if (frameCount < 2) {
+        return goofy_createBuffer(maxVertices, maxIndices, maxMeshes, 1, layout);
+    }
+    if (!goofy_hasGLVersion(4, 4)) {
+        printf("[GOOFYLIB3] Ring buffers need OpenGL 4.4, using a normal buffer instead\n");
+        return goofy_createBuffer(maxVertices, maxIndices, maxMeshes, 1, layout);
+    }
+    return goofy_createBuffer(maxVertices, maxIndices, maxMeshes, frameCount, layout);
+}
+GOOFY_BUFFER goofy_initBuffer(GLuint maxVertices, GLuint maxIndices, size_t maxMeshes) {
+    GOOFY_VERTEX_LAYOUT layout = goofy_fullLayout();
+    return goofy_initBufferLayout(maxVertices, maxIndices, maxMeshes, 1, &layout);
+}
+GOOFY_BUFFER goofy_initRingBuffer(GLuint maxVertices, GLuint maxIndices, size_t maxMeshes, unsigned int frameCount) {
+    GOOFY_VERTEX_LAYOUT layout = goofy_fullLayout();
+    return goofy_initBufferLayout(maxVertices, maxIndices, maxMeshes, frameCount, &layout);
+}
+GOOFY_BUFFER goofy_initPackedBuffer(GLuint maxVertices, GLuint maxIndices, size_t maxMeshes, unsigned int frameCount) {
+    GOOFY_VERTEX_LAYOUT layout = goofy_packedLayout();
+    return goofy_initBufferLayout(maxVertices, maxIndices, maxMeshes, frameCount, &layout);
+}
+// waits for every region, used before overwriting retained data the gpu might still read
+static void goofy_waitAllFrames(GOOFY_BUFFER* buffer) {
+    unsigned int current = buffer->currentFrame;
+    char ready = buffer->frameReady;
+    for (unsigned int i = 0; i < buffer->frameCount; ++i) {
+        buffer->currentFrame = i;
+        goofy_waitFrame(buffer);
+    }
+    buffer->currentFrame = current;
+    buffer->frameReady = ready;
+}
+// indices are relative to the base vertex, so 16 bits are enough for any mesh up to 65536 vertices
+static GLenum goofy_indexType(size_t vertexCount) {
+    return vertexCount <= 65536 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+// index space is counted in 16 bit units, rounded up to even so 32 bit indices stay 4 byte aligned
+static size_t goofy_indexUnits(size_t indexCount, GLenum type) {
+    return type == GL_UNSIGNED_INT ? indexCount * 2 : (indexCount + 1) & ~(size_t)1;
+}
+// space left for stream meshes, the current region ends at the next region or where retained meshes start
+static char goofy_streamFits(GOOFY_BUFFER* buffer, size_t vertexCount, size_t indexCount) {
+    size_t vertexStart = buffer->currentFrame * buffer->maxVertices;
+    size_t indexStart = buffer->currentFrame * buffer->maxIndices;
+    size_t vertexEnd = vertexStart + buffer->maxVertices;
+    size_t indexEnd = indexStart + buffer->maxIndices;
+    if (vertexEnd > buffer->retainedVertexBase) vertexEnd = buffer->retainedVertexBase;
+    if (indexEnd > buffer->retainedIndexBase) indexEnd = buffer->retainedIndexBase;
+    return vertexStart + buffer->currentVerticeOffset + vertexCount <= vertexEnd &&
+           indexStart + buffer->currentIndiceOffset + indexCount <= indexEnd;
+}
+// space left for a new retained mesh below the retained ones
+static char goofy_slotFits(GOOFY_BUFFER* buffer, size_t vertexCount, size_t indexCount) {
+    size_t streamVertexEnd = buffer->currentFrame * buffer->maxVertices + buffer->currentVerticeOffset;
+    size_t streamIndexEnd = buffer->currentFrame * buffer->maxIndices + buffer->currentIndiceOffset;
+    if (buffer->frameCount > 1) {
+        // every region of a ring buffer can still have meshes in it
+        streamVertexEnd = (buffer->frameCount - 1) * buffer->maxVertices + (buffer->currentFrame == buffer->frameCount - 1 ? buffer->currentVerticeOffset : 0);
+        streamIndexEnd = (buffer->frameCount - 1) * buffer->maxIndices + (buffer->currentFrame == buffer->frameCount - 1 ? buffer->currentIndiceOffset : 0);
+    }
+    return buffer->retainedVertexBase >= streamVertexEnd + vertexCount && buffer->retainedIndexBase >= streamIndexEnd + indexCount;
+}
+static void goofy_copyBuffer(GLuint from, GLuint to, size_t fromOffset, size_t toOffset, size_t size) {
+    if (size == 0) return;
+    glBindBuffer(GL_COPY_READ_BUFFER, from);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, to);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, (GLintptr)fromOffset, (GLintptr)toOffset, (GLsizeiptr)size);
+}
+// moves everything into bigger storage, the copies stay on the gpu
+static void goofy_resizeBuffer(GOOFY_BUFFER* buffer, size_t newMaxVertices, size_t newMaxIndices) {
+    GLuint oldVBO = buffer->VBO;
+    GLuint oldEBO = buffer->EBO;
+    size_t oldMaxVertices = buffer->maxVertices;
+    size_t oldMaxIndices = buffer->maxIndices;
+    size_t oldVertexTotal = oldMaxVertices * buffer->frameCount;
+    size_t oldIndexTotal = oldMaxIndices * buffer->frameCount;
+
+    buffer->maxVertices = newMaxVertices;
+    buffer->maxIndices = newMaxIndices;
+    buffer->mappedVertices = NULL;
+    buffer->mappedIndices = NULL;
+    glBindVertexArray(buffer->VAO);
+    goofy_allocStorage(buffer);
+    goofy_setVertexAttributes(buffer);
+    glBindVertexArray(0);
+
+    // stream meshes of this frame keep their place inside the current region
+    size_t vertexShift = buffer->currentFrame * (newMaxVertices - oldMaxVertices);
+    size_t indexShift = buffer->currentFrame * (newMaxIndices - oldMaxIndices);
+    goofy_copyBuffer(oldVBO, buffer->VBO, buffer->currentFrame * oldMaxVertices * buffer->vertexSize,
+                     buffer->currentFrame * newMaxVertices * buffer->vertexSize, buffer->currentVerticeOffset * buffer->vertexSize);
+    goofy_copyBuffer(oldEBO, buffer->EBO, buffer->currentFrame * oldMaxIndices * GOOFY_INDEX_UNIT,
+                     buffer->currentFrame * newMaxIndices * GOOFY_INDEX_UNIT, buffer->currentIndiceOffset * GOOFY_INDEX_UNIT);
+    for (size_t i = 0; i < buffer->meshCount; ++i) {
+        buffer->vertexOffsets[i] += vertexShift;
+        buffer->indexOffsets[i] += indexShift;
+    }
+    buffer->lastIndexOffset += indexShift;
+
+    // retained meshes stay at the end
+    size_t retainedVertexShift = newMaxVertices * buffer->frameCount - oldVertexTotal;
+    size_t retainedIndexShift = newMaxIndices * buffer->frameCount - oldIndexTotal;
+    goofy_copyBuffer(oldVBO, buffer->VBO, buffer->retainedVertexBase * buffer->vertexSize,
+                     (buffer->retainedVertexBase + retainedVertexShift) * buffer->vertexSize, (oldVertexTotal - buffer->retainedVertexBase) * buffer->vertexSize);
+    goofy_copyBuffer(oldEBO, buffer->EBO, buffer->retainedIndexBase * GOOFY_INDEX_UNIT,
+                     (buffer->retainedIndexBase + retainedIndexShift) * GOOFY_INDEX_UNIT, (oldIndexTotal - buffer->retainedIndexBase) * GOOFY_INDEX_UNIT);
+    buffer->retainedVertexBase += retainedVertexShift;
+    buffer->retainedIndexBase += retainedIndexShift;
+    for (size_t i = 0; i < buffer->slotCount; ++i) {
+        buffer->slots[i].vertexOffset += retainedVertexShift;
+        buffer->slots[i].indexOffset += retainedIndexShift;
+    }
+    buffer->commandDirtyStart = 0;
+    buffer->commandDirtyEnd = buffer->slotCount;
+
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glDeleteBuffers(1, &oldVBO);
+    glDeleteBuffers(1, &oldEBO);
+
+    if (buffer->frameCount > 1) {
+        // old fences belong to the old storage, but the copies have to land before we memcpy next to them
+        for (unsigned int i = 0; i < buffer->frameCount; ++i) {
+            if (buffer->fences[i]) glDeleteSync(buffer->fences[i]);
+            buffer->fences[i] = NULL;
+        }
+        buffer->fences[buffer->currentFrame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        goofy_waitFrame(buffer);
+    }
+    printf("[GOOFYLIB3] Grew buffer to %zu vertices and %zu 16 bit indices\n", newMaxVertices, newMaxIndices);
+}
+// grows the buffer (doubling) until vertexCount/indexCount fit as stream or retained data, up to the ceiling
+static char goofy_growBuffer(GOOFY_BUFFER* buffer, size_t vertexCount, size_t indexCount, char forSlot) {
+    for (;;) {
+        char fits = forSlot ? goofy_slotFits(buffer, vertexCount, indexCount) : goofy_streamFits(buffer, vertexCount, indexCount);
+        if (fits) return 1;
+
+        // check each side on its own so only the full one grows
+        size_t newMaxVertices = buffer->maxVertices;
+        size_t newMaxIndices = buffer->maxIndices;
+        char vertexFits = forSlot ? goofy_slotFits(buffer, vertexCount, 0) : goofy_streamFits(buffer, vertexCount, 0);
+        char indexFits = forSlot ? goofy_slotFits(buffer, 0, indexCount) : goofy_streamFits(buffer, 0, indexCount);
+        if (!vertexFits) newMaxVertices = newMaxVertices ? newMaxVertices * 2 : 1024;
+        if (!indexFits) newMaxIndices = newMaxIndices ? newMaxIndices * 2 : 1024;
+        if (newMaxVertices > buffer->vertexCeiling) newMaxVertices = buffer->vertexCeiling;
+        if (newMaxIndices > buffer->indexCeiling) newMaxIndices = buffer->indexCeiling;
+        // base vertices are GLints
+        if (newMaxVertices * buffer->frameCount > INT_MAX) newMaxVertices = INT_MAX / buffer->frameCount;
+        if (newMaxVertices <= buffer->maxVertices && newMaxIndices <= buffer->maxIndices) return 0;
+        if (newMaxVertices < buffer->maxVertices) newMaxVertices = buffer->maxVertices;
+        if (newMaxIndices < buffer->maxIndices) newMaxIndices = buffer->maxIndices;
+
+        goofy_resizeBuffer(buffer, newMaxVertices, newMaxIndices);
+    }
+}
+static char goofy_growMeshArrays(GOOFY_BUFFER* buffer) {
+    size_t newMax = buffer->MAX_MESHES ? buffer->MAX_MESHES * 2 : 64;
+    if (newMax > buffer->meshCeiling) newMax = buffer->meshCeiling;
+    if (newMax <= buffer->MAX_MESHES) return 0;
+
+    size_t* vertexOffsets = realloc(buffer->vertexOffsets, sizeof(size_t) * newMax);
+    if (vertexOffsets) buffer->vertexOffsets = vertexOffsets;
+    size_t* indexOffsets = realloc(buffer->indexOffsets, sizeof(size_t) * newMax);
+    if (indexOffsets) buffer->indexOffsets = indexOffsets;
+    size_t* vertexCounts = realloc(buffer->vertexCounts, sizeof(size_t) * newMax);
+    if (vertexCounts) buffer->vertexCounts = vertexCounts;
+    size_t* indexCounts = realloc(buffer->indexCounts, sizeof(size_t) * newMax);
+    if (indexCounts) buffer->indexCounts = indexCounts;
+    GLenum* indexTypes = realloc(buffer->indexTypes, sizeof(GLenum) * newMax);
+    if (indexTypes) buffer->indexTypes = indexTypes;
+    GLuint* instanceCounts = realloc(buffer->instanceCounts, sizeof(GLuint) * newMax);
+    if (instanceCounts) buffer->instanceCounts = instanceCounts;
+    GLuint* baseInstances = realloc(buffer->baseInstances, sizeof(GLuint) * newMax);
+    if (baseInstances) buffer->baseInstances = baseInstances;
+    if (!vertexOffsets || !indexOffsets || !vertexCounts || !indexCounts || !indexTypes || !instanceCounts || !baseInstances) {
+        fprintf(stderr, "[GOOFYLIB3] Failed to grow mesh arrays\n");
+        return 0;
+    }
+    buffer->MAX_MESHES = newMax;
+    goofy_countGrowths(buffer, 7);
+    return 1;
+}
+void goofy_setBufferCeiling(GOOFY_BUFFER* buffer, size_t maxVertices, size_t maxIndices, size_t maxMeshes) {
+    buffer->vertexCeiling = maxVertices;
+    buffer->indexCeiling = maxIndices > (size_t)-1 / 2 ? (size_t)-1 : maxIndices * 2;
+    buffer->meshCeiling = maxMeshes;
+}
+// converts to upload formats, kept in the buffer so uploads dont malloc
+static char goofy_reserveScratch(GOOFY_BUFFER* buffer, size_t size) {
+    if (size <= buffer->scratchSize) return 1;
+    size_t newSize = buffer->scratchSize ? buffer->scratchSize : 4096;
+    while (newSize < size) newSize *= 2;
+    unsigned char* scratch = realloc(buffer->scratch, newSize);
+    if (!scratch) {
+        fprintf(stderr, "[GOOFYLIB3] Failed to allocate upload memory\n");
+        return 0;
+    }
+    buffer->scratch = scratch;
+    goofy_countGrowths(buffer, 1);
+    buffer->scratchSize = newSize;
+    return 1;
+}
+void goofy_packVertices(const GOOFY_VERTICE* vertices, GOOFY_PACKED_VERTICE* packed, size_t count, const GOOFY_BOUNDS* box) {
+    // positions go to 0..1 inside the box, a flat axis (size 0) is all 0
+    float offset[3] = {0.0f, 0.0f, 0.0f};
+    float inverse[3] = {1.0f, 1.0f, 1.0f};
+    if (box) {
+        for (int c = 0; c < 3; ++c) {
+            float size = box->max[c] - box->min[c];
+            offset[c] = box->min[c];
+            inverse[c] = size > 0.0f ? 1.0f / size : 0.0f;
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        const GOOFY_VERTICE* v = &vertices[i];
+        GOOFY_PACKED_VERTICE* p = &packed[i];
+        p->position[0] = goofy_packUnorm16((v->position[0] - offset[0]) * inverse[0]);
+        p->position[1] = goofy_packUnorm16((v->position[1] - offset[1]) * inverse[1]);
+        p->position[2] = goofy_packUnorm16((v->position[2] - offset[2]) * inverse[2]);
+        p->texIndex = (short)v->texIndex;
+        p->normal = goofy_packSnorm10(v->normals[0]) | (goofy_packSnorm10(v->normals[1]) << 10) | (goofy_packSnorm10(v->normals[2]) << 20);
+        p->colors[0] = goofy_packUnorm8(v->colors[0]);
+        p->colors[1] = goofy_packUnorm8(v->colors[1]);
+        p->colors[2] = goofy_packUnorm8(v->colors[2]);
+        p->colors[3] = (unsigned char)v->is3d;
+        p->texCoords[0] = goofy_floatToHalf(v->texCoords[0]);
+        p->texCoords[1] = goofy_floatToHalf(v->texCoords[1]);
+    }
+}
+// what the packed positions of a draw decode with, box NULL = they are used as they are
+static void goofy_setPositionDecode(GOOFY_INSTANCE* instance, const GOOFY_BOUNDS* box) {
+    for (int c = 0; c < 3; ++c) {
+        instance->positionScale[c] = box ? box->max[c] - box->min[c] : 1.0f;
+        instance->positionOffset[c] = box ? box->min[c] : 0.0f;
+    }
+    instance->positionScale[3] = 0.0f;
+    instance->positionOffset[3] = 0.0f;
+}
+static char goofy_sameDecode(const GOOFY_INSTANCE* instance, const GOOFY_BOUNDS* box) {
+    GOOFY_INSTANCE decode;
+    goofy_setPositionDecode(&decode, box);
+    return memcmp(decode.positionScale, instance->positionScale, sizeof(decode.positionScale)) == 0 &&
+           memcmp(decode.positionOffset, instance->positionOffset, sizeof(decode.positionOffset)) == 0;
+}
+// packed buffers quantize positions inside the box of the mesh, other layouts dont need one
+static const GOOFY_BOUNDS* goofy_packingBox(const GOOFY_BUFFER* buffer, GOOFY_MESH* mesh) {
+    return buffer->vertexFormat == GOOFY_VERTEX_PACKED ? goofy_meshBounds(mesh) : NULL;
+}
+// converts vertices into the buffer's layout, doesnt touch the buffer so any thread can do it
+static void goofy_convertInto(const GOOFY_BUFFER* buffer, const GOOFY_VERTICE* vertices, size_t vertexCount, const GOOFY_BOUNDS* box, unsigned char* dst) {
+    if (buffer->vertexFormat == GOOFY_VERTEX_FULL) {
+        memcpy(dst, vertices, vertexCount * buffer->vertexSize);
+    } else if (buffer->vertexFormat == GOOFY_VERTEX_PACKED) {
+        goofy_packVertices(vertices, (GOOFY_PACKED_VERTICE*)dst, vertexCount, box);
+    } else {
+        goofy_convertVertices(&buffer->layout, vertices, dst, vertexCount);
+    }
+}
+static void goofy_narrowIndices(const unsigned int* indices, size_t indexCount, unsigned short* dst) {
+    for (size_t i = 0; i < indexCount; ++i) {
+        dst[i] = (unsigned short)indices[i];
+    }
+}
+// writes a mesh at absolute vertex/index offsets, indices stay as they are and get rebased by the base vertex when drawing
+static void goofy_writeVertices(GOOFY_BUFFER* buffer, const void* vertices, size_t vertexCount, char raw, const GOOFY_BOUNDS* box, size_t vertexOffset) {
+    goofy_countUpload(buffer, vertexCount, 0, vertexCount * buffer->vertexSize);
+    size_t size = vertexCount * buffer->vertexSize;
+    const void* data = vertices;
+    if (!raw && buffer->vertexFormat != GOOFY_VERTEX_FULL) {
+        unsigned char* dst;
+        if (buffer->mappedVertices) {
+            dst = buffer->mappedVertices + vertexOffset * buffer->vertexSize; // convert straight into the mapped memory
+        } else {
+            if (!goofy_reserveScratch(buffer, size)) return;
+            dst = buffer->scratch;
+        }
+        goofy_convertInto(buffer, (const GOOFY_VERTICE*)vertices, vertexCount, box, dst);
+        if (buffer->mappedVertices) return;
+        data = buffer->scratch;
+    }
+
+    if (buffer->mappedVertices) {
+        memcpy(buffer->mappedVertices + vertexOffset * buffer->vertexSize, data, size);
+        return;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, buffer->VBO);
+    glBufferSubData(GL_ARRAY_BUFFER, vertexOffset * buffer->vertexSize, size, data);
+}
+// indexOffset is in 16 bit units, 16 bit indices get narrowed on the way
+static void goofy_writeIndices(GOOFY_BUFFER* buffer, const unsigned int* indices, size_t indexCount, GLenum indexType, size_t indexOffset) {
+    goofy_countUpload(buffer, 0, indexCount, indexCount * (indexType == GL_UNSIGNED_INT ? sizeof(unsigned int) : sizeof(unsigned short)));
+    if (indexType == GL_UNSIGNED_INT) {
+        if (buffer->mappedIndices) {
+            memcpy(buffer->mappedIndices + indexOffset, indices, indexCount * sizeof(unsigned int));
+            return;
+        }
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer->EBO);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexOffset * GOOFY_INDEX_UNIT, indexCount * sizeof(unsigned int), indices);
+        return;
+    }
+
+    unsigned short* dst = buffer->mappedIndices ? buffer->mappedIndices + indexOffset : NULL;
+    if (!dst) {
+        if (!goofy_reserveScratch(buffer, indexCount * sizeof(unsigned short))) return;
+        dst = (unsigned short*)buffer->scratch;
+    }
+    goofy_narrowIndices(indices, indexCount, dst);
+    if (buffer->mappedIndices) return;
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer->EBO);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexOffset * GOOFY_INDEX_UNIT, indexCount * sizeof(unsigned short), dst);
+}
+static void goofy_writeMesh(GOOFY_BUFFER* buffer, GOOFY_MESH* mesh, size_t vertexOffset, size_t indexOffset, GLenum indexType) {
+    goofy_writeVertices(buffer, mesh->vertices, mesh->vertexCount, 0, goofy_packingBox(buffer, mesh), vertexOffset);
+    goofy_writeIndices(buffer, mesh->indices, mesh->indexCount, indexType, indexOffset);
+}
+// makes room for count more instance records, keeps the ones already there
+static char goofy_reserveInstances(GOOFY_BUFFER* buffer, size_t count) {
+    size_t needed = buffer->instanceCount + count;
+    if (needed <= buffer->instanceCapacity) return 1;
+    size_t newCapacity = buffer->instanceCapacity ? buffer->instanceCapacity : 256;
+    while (newCapacity < needed) newCapacity *= 2;
+
+    GOOFY_INSTANCE* instances = realloc(buffer->instances, sizeof(GOOFY_INSTANCE) * newCapacity);
+    if (!instances) {
+        fprintf(stderr, "[GOOFYLIB3] Failed to allocate instance data\n");
+        return 0;
+    }
+    buffer->instances = instances;
+    goofy_countGrowths(buffer, 1);
+    buffer->instanceCapacity = newCapacity;
+    glBindBuffer(GL_ARRAY_BUFFER, buffer->instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(GOOFY_INSTANCE) * newCapacity, NULL, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(GOOFY_INSTANCE) * buffer->instanceCount, buffer->instances);
+    return 1;
+}
+// copies instance records (NULL = identity ones) behind the others with the position decode of box and uploads them, returns the first.
+// goofy_reserveInstances has to have made room
+static size_t goofy_appendInstances(GOOFY_BUFFER* buffer, const GOOFY_INSTANCE* instances, size_t count, const GOOFY_BOUNDS* box) {
+    size_t first = buffer->instanceCount;
+    GOOFY_INSTANCE* records = buffer->instances + first;
+    for (size_t i = 0; i < count; ++i) {
+        records[i] = instances ? instances[i] : goofy_translationInstance(0.0f, 0.0f, 0.0f);
+        goofy_setPositionDecode(&records[i], box);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, buffer->instanceVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, sizeof(GOOFY_INSTANCE) * first, sizeof(GOOFY_INSTANCE) * count, records);
+    goofy_countUpload(buffer, 0, 0, sizeof(GOOFY_INSTANCE) * count);
+    buffer->instanceCount += count;
+    return first;
+}
+// raw vertices are already in the buffer's layout and get copied as they are, box is where packed positions get quantized
+static char goofy_submitVertices(GOOFY_BUFFER* buffer, const void* vertices, size_t vertexCount, char raw, const GOOFY_BOUNDS* box,
+                                 const unsigned int* indices, size_t indexCount, char shareIndices) {
+    if (buffer->meshCount >= buffer->MAX_MESHES && !goofy_growMeshArrays(buffer)) {
+        fprintf(stderr, "Exceeded max mesh count!\n");
+        return 0;
+    }
+    if (shareIndices && (buffer->meshCount == 0 || buffer->lastIndices != indices || buffer->lastIndexCount != indexCount)) {
+        shareIndices = 0; // nothing to share with, upload normally
+    }
+    GLenum indexType = shareIndices ? buffer->lastIndexType : goofy_indexType(vertexCount);
+    size_t newIndices = shareIndices ? 0 : goofy_indexUnits(indexCount, indexType);
+
+    if (!goofy_streamFits(buffer, vertexCount, newIndices) && !goofy_growBuffer(buffer, vertexCount, newIndices, 0)) {
+        fprintf(stderr, "[GOOFYLIB3] Buffer is full, mesh skipped\n");
+        return 0;
+    }
+    size_t vertexStart = buffer->currentFrame * buffer->maxVertices;
+    size_t indexStart = buffer->currentFrame * buffer->maxIndices;
+    if (buffer->frameCount > 1 && !buffer->frameReady) goofy_waitFrame(buffer);
+
+    size_t vertexBase = vertexStart + buffer->currentVerticeOffset;
+    size_t indexBase = shareIndices ? buffer->lastIndexOffset : indexStart + buffer->currentIndiceOffset;
+    goofy_writeVertices(buffer, vertices, vertexCount, raw, box, vertexBase);
+    if (!shareIndices) goofy_writeIndices(buffer, indices, indexCount, indexType, indexBase);
+
+    goofy_countMeshes(buffer, 1);
+    size_t idx = buffer->meshCount++;
+    buffer->vertexOffsets[idx] = vertexBase;
+    buffer->indexOffsets[idx] = indexBase;
+    buffer->currentIndiceOffset += newIndices;
+    buffer->currentVerticeOffset += vertexCount;
+    buffer->vertexCounts[idx] = vertexCount;
+    buffer->indexCounts[idx] = indexCount;
+    buffer->indexTypes[idx] = indexType;
+    buffer->instanceCounts[idx] = 1;
+    buffer->baseInstances[idx] = 0;
+    buffer->lastIndices = indices;
+    buffer->lastIndexCount = indexCount;
+    buffer->lastIndexOffset = indexBase;
+    buffer->lastIndexType = indexType;
+    return 1;
+}
+static char goofy_submitMesh(GOOFY_BUFFER* buffer, GOOFY_MESH* mesh, char shareIndices) {
+    // packed meshes draw with an instance record of their own, it has the box their positions decode with
+    const GOOFY_BOUNDS* box = goofy_packingBox(buffer, mesh);
+    if (box && !goofy_reserveInstances(buffer, 1)) return 0;
+    if (!goofy_submitVertices(buffer, mesh->vertices, mesh->vertexCount, 0, box, mesh->indices, mesh->indexCount, shareIndices)) return 0;
+    if (box) buffer->baseInstances[buffer->meshCount - 1] = (GLuint)goofy_appendInstances(buffer, NULL, 1, box);
+    return 1;
+}
+void goofy_renderMesh(GOOFY_BUFFER* buffer, GOOFY_MESH* mesh) {
+    GOOFY_ZONE_BEGIN("goofy_renderMesh");
+    uint64_t start = goofy_statsNow();
+    goofy_submitMesh(buffer, mesh, 0);
+    goofy_recordLatency(&goofy_stats.renderMesh, start);
+    GOOFY_ZONE_END();
+}
+void goofy_renderRawMesh(GOOFY_BUFFER* buffer, const void* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount) {
+    goofy_submitVertices(buffer, vertices, vertexCount, 1, NULL, indices, indexCount, 0);
+}
+void goofy_renderMeshSharedIndices(GOOFY_BUFFER* buffer, GOOFY_MESH* mesh) {
+    goofy_submitMesh(buffer, mesh, 1);
+}
+
+// CONCURRENT-SUBMIT functions
+char goofy_beginConcurrentSubmit(GOOFY_BUFFER* buffer, size_t maxVertices, size_t maxIndices, size_t maxMeshes) {
+    if (!buffer->concurrent) {
+        buffer->concurrent = (GOOFY_SUBMIT_STATE*)calloc(1, sizeof(GOOFY_SUBMIT_STATE));
+        if (!buffer->concurrent) {
+            fprintf(stderr, "[GOOFYLIB3] Failed to allocate concurrent submit state\n");
+            return 0;
+        }
+    }
+    GOOFY_SUBMIT_STATE* state = buffer->concurrent;
+    if (state->active) {
+        fprintf(stderr, "[GOOFYLIB3] Concurrent submit already started\n");
+        return 0;
+    }
+
+    // everything that needs OpenGL happens here, the workers only copy
+    size_t indexUnits = maxIndices > (size_t)-1 / 2 ? (size_t)-1 : maxIndices * 2;
+    if ((maxVertices || maxIndices) && !goofy_streamFits(buffer, maxVertices, indexUnits) && !goofy_growBuffer(buffer, maxVertices, indexUnits, 0)) {
+        fprintf(stderr, "[GOOFYLIB3] Buffer cant grow enough for concurrent submit, workers get what is left\n");
+    }
+    while (buffer->meshCount + maxMeshes > buffer->MAX_MESHES && goofy_growMeshArrays(buffer)) {}
+    if (buffer->frameCount > 1 && !buffer->frameReady) goofy_waitFrame(buffer);
+
+    state->vertexStart = buffer->currentFrame * buffer->maxVertices;
+    state->indexStart = buffer->currentFrame * buffer->maxIndices;
+    size_t vertexEnd = state->vertexStart + buffer->maxVertices;
+    size_t indexEnd = state->indexStart + buffer->maxIndices;
+    if (vertexEnd > buffer->retainedVertexBase) vertexEnd = buffer->retainedVertexBase;
+    if (indexEnd > buffer->retainedIndexBase) indexEnd = buffer->retainedIndexBase;
+    state->vertexLimit = vertexEnd - state->vertexStart;
+    state->indexLimit = indexEnd - state->indexStart;
+    state->firstVertex = buffer->currentVerticeOffset;
+    state->firstIndex = buffer->currentIndiceOffset;
+
+    if (buffer->mappedVertices && buffer->mappedIndices) {
+        state->vertices = buffer->mappedVertices + state->vertexStart * buffer->vertexSize;
+        state->indices = buffer->mappedIndices + state->indexStart;
+    } else {
+        size_t vertexSize = state->vertexLimit * buffer->vertexSize;
+        size_t indexSize = state->indexLimit * GOOFY_INDEX_UNIT;
+        if (vertexSize > state->stagingVertexSize) {
+            unsigned char* staging = realloc(state->stagingVertices, vertexSize);
+            if (!staging) {
+                fprintf(stderr, "[GOOFYLIB3] Failed to allocate concurrent submit memory\n");
+                return 0;
+            }
+            state->stagingVertices = staging;
+            goofy_countGrowths(buffer, 1);
+            state->stagingVertexSize = vertexSize;
+        }
+        if (indexSize > state->stagingIndexSize) {
+            unsigned short* staging = realloc(state->stagingIndices, indexSize);
+            if (!staging) {
+                fprintf(stderr, "[GOOFYLIB3] Failed to allocate concurrent submit memory\n");
+                return 0;
+            }
+            state->stagingIndices = staging;
+            goofy_countGrowths(buffer, 1);
+            state->stagingIndexSize = indexSize;
+        }
+        state->vertices = state->stagingVertices;
+        state->indices = state->stagingIndices;
+    }
+    if (buffer->vertexFormat == GOOFY_VERTEX_PACKED && buffer->MAX_MESHES > state->boxCapacity) {
+        GOOFY_BOUNDS* boxes = realloc(state->boxes, sizeof(GOOFY_BOUNDS) * buffer->MAX_MESHES);
+        if (!boxes) {
+            fprintf(stderr, "[GOOFYLIB3] Failed to allocate concurrent submit memory\n");
+            return 0;
+        }
+        state->boxes = boxes;
+        goofy_countGrowths(buffer, 1);
+        state->boxCapacity = buffer->MAX_MESHES;
+    }
+
+    atomic_store(&state->vertexOffset, buffer->currentVerticeOffset);
+    atomic_store(&state->indexOffset, buffer->currentIndiceOffset);
+    atomic_store(&state->meshCount, buffer->meshCount);
+    atomic_store(&state->dropped, 0);
+    state->active = 1;
+    return 1;
+}
+// takes count from counter only when it stays within limit, so a mesh that doesnt fit leaves the space to the ones after it
+static char goofy_reserveConcurrent(atomic_size_t* counter, size_t count, size_t limit, size_t* base) {
+    size_t current = atomic_load(counter);
+    do {
+        if (count > limit || current > limit - count) return 0;
+    } while (!atomic_compare_exchange_weak(counter, &current, current + count));
+    *base = current;
+    return 1;
+}
+static char goofy_dropConcurrent(GOOFY_SUBMIT_STATE* state) {
+    if (atomic_fetch_add(&state->dropped, 1) == 0) {
+        fprintf(stderr, "[GOOFYLIB3] Concurrent submit is full, meshes that dont fit are skipped (see meshesDropped in the stats)\n");
+    }
+    return 0;
+}
+char goofy_renderMeshConcurrent(GOOFY_BUFFER* buffer, GOOFY_MESH* mesh) {
+    GOOFY_SUBMIT_STATE* state = buffer->concurrent;
+    if (!state || !state->active) {
+        fprintf(stderr, "[GOOFYLIB3] goofy_renderMeshConcurrent called without goofy_beginConcurrentSubmit\n");
+        return 0;
+    }
+    GLenum indexType = goofy_indexType(mesh->vertexCount);
+    size_t indexUnits = goofy_indexUnits(mesh->indexCount, indexType);
+    // space first and the entry last, when a later step fails the space before it is just a hole that draws nothing
+    size_t vertexBase, indexBase, idx;
+    if (!goofy_reserveConcurrent(&state->vertexOffset, mesh->vertexCount, state->vertexLimit, &vertexBase)) return goofy_dropConcurrent(state);
+    if (!goofy_reserveConcurrent(&state->indexOffset, indexUnits, state->indexLimit, &indexBase)) return goofy_dropConcurrent(state);
+    if (!goofy_reserveConcurrent(&state->meshCount, 1, buffer->MAX_MESHES, &idx)) return goofy_dropConcurrent(state);
+
+    buffer->vertexOffsets[idx] = state->vertexStart + vertexBase;
+    buffer->indexOffsets[idx] = state->indexStart + indexBase;
+    buffer->indexTypes[idx] = indexType;
+    buffer->instanceCounts[idx] = 1;
+    buffer->baseInstances[idx] = 0;
+    const GOOFY_BOUNDS* box = goofy_packingBox(buffer, mesh);
+    if (box) state->boxes[idx] = *box;
+    goofy_convertInto(buffer, mesh->vertices, mesh->vertexCount, box, state->vertices + vertexBase * buffer->vertexSize);
+    if (indexType == GL_UNSIGNED_INT) {
+        memcpy(state->indices + indexBase, mesh->indices, mesh->indexCount * sizeof(unsigned int));
+    } else {
+        goofy_narrowIndices(mesh->indices, mesh->indexCount, state->indices + indexBase);
+    }
+    buffer->vertexCounts[idx] = mesh->vertexCount;
+    buffer->indexCounts[idx] = mesh->indexCount;
+    return 1;
+}
+void goofy_endConcurrentSubmit(GOOFY_BUFFER* buffer) {
+    GOOFY_SUBMIT_STATE* state = buffer->concurrent;
+    if (!state || !state->active) return;
+    state->active = 0;
+
+    // the counters never go past the limits, meshes that didnt fit took nothing
+    size_t vertexEnd = atomic_load(&state->vertexOffset);
+    size_t indexEnd = atomic_load(&state->indexOffset);
+    size_t meshCount = atomic_load(&state->meshCount);
+
+    if (state->vertices == state->stagingVertices) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer->VBO);
+        glBufferSubData(GL_ARRAY_BUFFER, (state->vertexStart + state->firstVertex) * buffer->vertexSize,
+                        (vertexEnd - state->firstVertex) * buffer->vertexSize, state->stagingVertices + state->firstVertex * buffer->vertexSize);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer->EBO);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, (state->indexStart + state->firstIndex) * GOOFY_INDEX_UNIT,
+                        (indexEnd - state->firstIndex) * GOOFY_INDEX_UNIT, state->stagingIndices + state->firstIndex);
+    }
+    // packed meshes get their instance record here, the workers cant touch the instance buffer
+    if (buffer->vertexFormat == GOOFY_VERTEX_PACKED && meshCount > buffer->meshCount && goofy_reserveInstances(buffer, meshCount - buffer->meshCount)) {
+        size_t first = buffer->instanceCount;
+        for (size_t i = buffer->meshCount; i < meshCount; ++i) {
+            GOOFY_INSTANCE* record = &buffer->instances[buffer->instanceCount];
+            *record = goofy_translationInstance(0.0f, 0.0f, 0.0f);
+            goofy_setPositionDecode(record, buffer->vertexCounts[i] ? &state->boxes[i] : NULL); // empty meshes have no box
+            buffer->baseInstances[i] = (GLuint)buffer->instanceCount++;
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, buffer->instanceVBO);
+        glBufferSubData(GL_ARRAY_BUFFER, sizeof(GOOFY_INSTANCE) * first, sizeof(GOOFY_INSTANCE) * (buffer->instanceCount - first), buffer->instances + first);
+        goofy_countUpload(buffer, 0, 0, sizeof(GOOFY_INSTANCE) * (buffer->instanceCount - first));
+    }
+    // the workers dont count, everything they wrote is counted here
+    goofy_countMeshes(buffer, meshCount - buffer->meshCount);
+    goofy_countDropped(buffer, atomic_load(&state->dropped));
+    goofy_countUpload(buffer, vertexEnd - state->firstVertex, 0, (vertexEnd - state->firstVertex) * buffer->vertexSize);
+    goofy_countUpload(buffer, 0, 0, (indexEnd - state->firstIndex) * GOOFY_INDEX_UNIT); // 16 and 32 bit indices are mixed in there
+    buffer->currentVerticeOffset = vertexEnd;
+    buffer->currentIndiceOffset = indexEnd;
+    buffer->meshCount = meshCount;
+    buffer->lastIndices = NULL; // the last mesh isnt known, nothing to share indices with
+}
+void goofy_renderMeshInstanced(GOOFY_BUFFER* buffer, GOOFY_MESH* mesh, const GOOFY_INSTANCE* instances, size_t instanceCount) {
+    if (instanceCount == 0) return;
+    if (!goofy_reserveInstances(buffer, instanceCount)) return;
+    const GOOFY_BOUNDS* box = goofy_packingBox(buffer, mesh);
+    if (!goofy_submitVertices(buffer, mesh->vertices, mesh->vertexCount, 0, box, mesh->indices, mesh->indexCount, 0)) return;
+
+    size_t idx = buffer->meshCount - 1;
+    buffer->instanceCounts[idx] = (GLuint)instanceCount;
+    buffer->baseInstances[idx] = (GLuint)goofy_appendInstances(buffer, instances, instanceCount, box);
+}
+GOOFY_INSTANCE goofy_translationInstance(float x, float y, float z) {
+    GOOFY_INSTANCE instance = {
+        {1.0f, 0.0f, 0.0f, 0.0f,
+         0.0f, 1.0f, 0.0f, 0.0f,
+         0.0f, 0.0f, 1.0f, 0.0f,
+         x,    y,    z,    1.0f},
+        {1.0f, 1.0f, 1.0f},
+        -1,
+        {1.0f, 1.0f, 1.0f, 0.0f},
+        {0.0f, 0.0f, 0.0f, 0.0f}
+    };
+    return instance;
+}
+// makes sure the cached draw arrays fit drawCount draws
+static char goofy_reserveDraws(GOOFY_BUFFER* buffer, size_t drawCount) {
+    if (drawCount <= buffer->drawCapacity) return 1;
+    size_t newCapacity = buffer->drawCapacity ? buffer->drawCapacity : 64;
+    while (newCapacity < drawCount) newCapacity *= 2;
+
+    GLsizei* counts = realloc(buffer->drawCounts, sizeof(GLsizei) * newCapacity);
+    if (counts) buffer->drawCounts = counts;
+    const void** indexOffsets = realloc(buffer->drawIndexOffsets, sizeof(void*) * newCapacity);
+    if (indexOffsets) buffer->drawIndexOffsets = indexOffsets;
+    GLint* baseVertices = realloc(buffer->drawBaseVertices, sizeof(GLint) * newCapacity);
+    if (baseVertices) buffer->drawBaseVertices = baseVertices;
+    if (!counts || !indexOffsets || !baseVertices) {
+        fprintf(stderr, "[GOOFYLIB3] Failed to allocate draw arrays\n");
+        return 0;
+    }
+    buffer->drawCapacity = newCapacity;
+    goofy_countGrowths(buffer, 3);
+    return 1;
+}
+static void goofy_bindForDraw(GOOFY_BUFFER* buffer, GLuint shaderProgram, GOOFY_TEXTURE_ARRAY* textureArray) {
+    goofy_countBinds(buffer, 2);
+    glBindVertexArray(buffer->VAO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer->EBO);
+    goofy_bindDrawData(buffer);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray->textureArray);
+    goofy_setTextureUnit(shaderProgram);
+}
+// called after the draw of a frame was issued, resets the stream meshes
+static void goofy_finishDraw(GOOFY_BUFFER* buffer) {
+    if (buffer->frameCount > 1) {
+        // gpu is now reading this region, move on to the next one
+        buffer->fences[buffer->currentFrame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        buffer->currentFrame = (buffer->currentFrame + 1) % buffer->frameCount;
+        buffer->frameReady = 0;
+    }
+    buffer->currentIndiceOffset = 0;
+    buffer->currentVerticeOffset = 0;
+    buffer->meshCount = 0;
+    buffer->instanceCount = 1;
+}
+static size_t goofy_countDraws(GOOFY_BUFFER* buffer) {
+    size_t visibleSlots = 0;
+    for (size_t i = 0; i < buffer->slotCount; ++i) {
+        if (buffer->slots[i].used && buffer->slots[i].visible) visibleSlots++;
+    }
+    return buffer->meshCount + visibleSlots;
+}
+// the timer between goofy_beginGpuFrame and goofy_endGpuFrame, buffer draws time themselves with it
+static GOOFY_GPU_TIMER* goofy_activeGpuTimer = NULL;
+
+// writes the start timestamp of a scope, once the region is full scopes are only counted as dropped
+static void goofy_openGpuScope(GOOFY_GPU_TIMER* timer, const char* name, const GOOFY_BUFFER* buffer) {
+    size_t* used = &timer->pendingCounts[timer->currentFrame];
+    if (timer->droppedOpen > 0 || *used > timer->scopeCapacity) {
+        timer->droppedScopes++;
+        timer->droppedOpen++;
+        return;
+    }
+    size_t pair = timer->currentFrame * (timer->scopeCapacity + 1) + *used;
+    GOOFY_GPU_SCOPE_TIME* scope = &timer->pending[pair];
+    scope->name = name;
+    scope->buffer = buffer;
+    scope->depth = (unsigned int)timer->openCount;
+    scope->calls = 1;
+    scope->milliseconds = 0.0;
+    glQueryCounter(timer->queries[pair * 2], GL_TIMESTAMP);
+    timer->openScopes[timer->openCount++] = pair;
+    (*used)++;
+}
+static void goofy_closeGpuScope(GOOFY_GPU_TIMER* timer) {
+    if (timer->droppedOpen > 0) { // dropped ones are always the innermost, nothing fits after the first one
+        timer->droppedOpen--;
+        return;
+    }
+    if (timer->openCount == 0) return;
+    size_t pair = timer->openScopes[--timer->openCount];
+    glQueryCounter(timer->queries[pair * 2 + 1], GL_TIMESTAMP);
+}
+static void goofy_beginBufferTiming(const char* name, const GOOFY_BUFFER* buffer) {
+    if (goofy_activeGpuTimer) goofy_openGpuScope(goofy_activeGpuTimer, name, buffer);
+}
+static void goofy_endBufferTiming(void) {
+    if (goofy_activeGpuTimer) goofy_closeGpuScope(goofy_activeGpuTimer);
+}
+// issues the draws of a buffer that is already bound, doesnt reset anything. withSlots 0 = only the stream meshes
+static void goofy_issueDraws(GOOFY_BUFFER* buffer, char withSlots) {
+    size_t slotCount = withSlots ? buffer->slotCount : 0;
+    if (!goofy_reserveDraws(buffer, slotCount + buffer->meshCount)) return;
+
+    GLsizei* countArray = buffer->drawCounts;
+    const void** indexOffsetArray = buffer->drawIndexOffsets;
+    GLint* baseVertexArray = buffer->drawBaseVertices;
+
+    // one multi draw per index type, 16 bit meshes are the usual case
+    static const GLenum indexTypes[2] = {GL_UNSIGNED_SHORT, GL_UNSIGNED_INT};
+    size_t instancedDraws = 0;
+    for (int t = 0; t < 2; ++t) {
+        GLenum type = indexTypes[t];
+        size_t draw = 0, drawn = 0;
+        // every slot gets a draw (empty when it isnt drawn here) so gl_DrawID is the slot index, like the indirect path
+        for (size_t i = 0; i < slotCount; ++i) {
+            GOOFY_MESH_SLOT* slot = &buffer->slots[i];
+            char inDraw = slot->used && slot->visible && slot->indexType == type;
+            countArray[draw] = inDraw ? (GLsizei)slot->indexCount : 0;
+            indexOffsetArray[draw] = (const void*)(slot->indexOffset * GOOFY_INDEX_UNIT);
+            baseVertexArray[draw] = (GLint)slot->vertexOffset;
+            draw++;
+            drawn += inDraw;
+        }
+        for (size_t i = 0; i < buffer->meshCount; ++i) {
+            if (buffer->indexTypes[i] != type) continue;
+            if (buffer->baseInstances[i] != 0) {
+                instancedDraws++; // drawn on its own below
+                continue;
+            }
+            countArray[draw] = (GLsizei)buffer->indexCounts[i];
+            indexOffsetArray[draw] = (const void*)(buffer->indexOffsets[i] * GOOFY_INDEX_UNIT);
+            baseVertexArray[draw] = (GLint)buffer->vertexOffsets[i];
+            draw++;
+            drawn++;
+        }
+
+        if (drawn > 0) {
+            glMultiDrawElementsBaseVertex(
+                GL_TRIANGLES,
+                countArray,
+                type,
+                indexOffsetArray,
+                (GLsizei)draw,
+                baseVertexArray
+            );
+            goofy_countDrawCall(buffer, draw);
+        }
+    }
+    char baseInstance = GLAD_GL_VERSION_4_2;
+    if (instancedDraws > 0 && !baseInstance) glBindBuffer(GL_ARRAY_BUFFER, buffer->instanceVBO);
+    for (size_t i = 0; instancedDraws > 0 && i < buffer->meshCount; ++i) {
+        if (buffer->baseInstances[i] == 0) continue;
+        const void* indexOffset = (const void*)(buffer->indexOffsets[i] * GOOFY_INDEX_UNIT);
+        if (baseInstance) {
+            glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, (GLsizei)buffer->indexCounts[i], buffer->indexTypes[i], indexOffset,
+                                                          (GLsizei)buffer->instanceCounts[i], (GLint)buffer->vertexOffsets[i], buffer->baseInstances[i]);
+        } else {
+            goofy_pointInstanceAttributes(buffer->baseInstances[i]);
+            glDrawElementsInstancedBaseVertex(GL_TRIANGLES, (GLsizei)buffer->indexCounts[i], buffer->indexTypes[i], indexOffset,
+                                              (GLsizei)buffer->instanceCounts[i], (GLint)buffer->vertexOffsets[i]);
+        }
+        goofy_countDrawCall(buffer, 1);
+    }
+    if (instancedDraws > 0 && !baseInstance) goofy_pointInstanceAttributes(0);
+}
+void goofy_drawAllMeshes(GOOFY_BUFFER* buffer, GLuint shaderProgram,GOOFY_TEXTURE_ARRAY* textureArray) {
+    if (goofy_countDraws(buffer) == 0) return;
+
+    GOOFY_ZONE_BEGIN("goofy_drawAllMeshes");
+    uint64_t start = goofy_statsNow();
+    goofy_beginBufferTiming("goofy_drawAllMeshes", buffer);
+    goofy_bindForDraw(buffer, shaderProgram, textureArray);
+    goofy_issueDraws(buffer, 1);
+    goofy_finishDraw(buffer);
+    goofy_endBufferTiming();
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    goofy_recordLatency(&goofy_stats.drawAllMeshes, start);
+    GOOFY_ZONE_END();
+}
+// marks the indirect command of a slot as changed
+static void goofy_markSlotCommand(GOOFY_BUFFER* buffer, size_t slot) {
+    if (slot < buffer->commandDirtyStart) buffer->commandDirtyStart = slot;
+    if (slot + 1 > buffer->commandDirtyEnd) buffer->commandDirtyEnd = slot + 1;
+}
+// the command array has a 16 bit half and a 32 bit half (commandCapacity each), a slot only draws in the half of its index type
+static void goofy_fillSlotCommand(GOOFY_BUFFER* buffer, size_t slot) {
+    GOOFY_MESH_SLOT* meshSlot = &buffer->slots[slot];
+    char drawn = meshSlot->used && meshSlot->visible;
+    for (int half = 0; half < 2; ++half) {
+        GLenum type = half ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+        GOOFY_DRAW_COMMAND* command = &buffer->commands[half * buffer->commandCapacity + slot];
+        char inHalf = drawn && meshSlot->indexType == type;
+        command->count = inHalf ? (GLuint)meshSlot->indexCount : 0;
+        command->instanceCount = inHalf ? 1 : 0;
+        command->firstIndex = (GLuint)(type == GL_UNSIGNED_INT ? meshSlot->indexOffset / 2 : meshSlot->indexOffset);
+        command->baseVertex = (GLint)meshSlot->vertexOffset;
+        command->baseInstance = 0;
+    }
+}
+// (re)makes the culling buffers for commandCapacity slots, all bounds get uploaded again
+static void goofy_allocCullStorage(GOOFY_BUFFER* buffer) {
+    GLint alignment = 256;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    if (alignment <= 0) alignment = 256;
+    size_t capacity = buffer->commandCapacity;
+    size_t regionSize = GOOFY_DRAW_DATA_HEADER + sizeof(GOOFY_INSTANCE) * capacity;
+    regionSize = (regionSize + (size_t)alignment - 1) / (size_t)alignment * (size_t)alignment;
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer->boundsBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(float) * 4 * capacity, NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer->culledCommandBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(GOOFY_DRAW_COMMAND) * capacity * 2, NULL, GL_DYNAMIC_COPY);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer->culledDrawBuffer);
+    // the third region only has a zero slot count, stream meshes draw with it bound
+    glBufferData(GL_SHADER_STORAGE_BUFFER, regionSize * 2 + GOOFY_DRAW_DATA_HEADER, NULL, GL_DYNAMIC_COPY);
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    buffer->culledCapacity = capacity;
+    buffer->culledRegionSize = regionSize;
+    buffer->commandDirtyStart = 0;
+    buffer->commandDirtyEnd = buffer->slotCount;
+}
+// makes room for the slot and stream commands and uploads the slot commands (and bounds) that changed, leaves the indirect buffer bound
+static char goofy_uploadSlotCommands(GOOFY_BUFFER* buffer) {
+    if (buffer->indirectBuffer == 0) {
+        if (!goofy_hasGLVersion(4, 3)) return 0;
+        glGenBuffers(1, &buffer->indirectBuffer);
+    }
+
+    // slot commands come first and keep their index, stream meshes are appended after them every frame
+    size_t commandCount = buffer->slotCount + buffer->meshCount;
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer->indirectBuffer);
+    if (commandCount > buffer->commandCapacity) {
+        size_t newCapacity = buffer->commandCapacity ? buffer->commandCapacity : 64;
+        while (newCapacity < commandCount) newCapacity *= 2;
+        GOOFY_DRAW_COMMAND* commands = realloc(buffer->commands, sizeof(GOOFY_DRAW_COMMAND) * newCapacity * 2);
+        if (!commands) {
+            fprintf(stderr, "[GOOFYLIB3] Failed to allocate indirect commands\n");
+            return 0;
+        }
+        buffer->commands = commands;
+        goofy_countGrowths(buffer, 1);
+        buffer->commandCapacity = newCapacity;
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(GOOFY_DRAW_COMMAND) * newCapacity * 2, NULL, GL_DYNAMIC_DRAW);
+        // new storage, everything has to go up again
+        buffer->commandDirtyStart = 0;
+        buffer->commandDirtyEnd = buffer->slotCount;
+    }
+    if (buffer->boundsBuffer && buffer->culledCapacity != buffer->commandCapacity) {
+        goofy_allocCullStorage(buffer);
+    }
+
+    if (buffer->commandDirtyEnd > buffer->slotCount) buffer->commandDirtyEnd = buffer->slotCount;
+    if (buffer->commandDirtyStart < buffer->commandDirtyEnd) {
+        size_t start = buffer->commandDirtyStart;
+        size_t count = buffer->commandDirtyEnd - start;
+        for (size_t i = start; i < buffer->commandDirtyEnd; ++i) {
+            goofy_fillSlotCommand(buffer, i);
+        }
+        for (size_t half = 0; half < 2; ++half) {
+            size_t first = half * buffer->commandCapacity + start;
+            glBufferSubData(GL_DRAW_INDIRECT_BUFFER, sizeof(GOOFY_DRAW_COMMAND) * first,
+                            sizeof(GOOFY_DRAW_COMMAND) * count, buffer->commands + first);
+        }
+        goofy_countUpload(buffer, 0, 0, sizeof(GOOFY_DRAW_COMMAND) * count * 2);
+        // bounds change together with the commands, they sit in the slots so they get gathered first
+        if (buffer->boundsBuffer && goofy_reserveScratch(buffer, sizeof(float) * 4 * count)) {
+            float* bounds = (float*)buffer->scratch;
+            for (size_t i = 0; i < count; ++i) {
+                memcpy(bounds + i * 4, buffer->slots[start + i].bounds, sizeof(float) * 4);
+            }
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer->boundsBuffer);
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, sizeof(float) * 4 * start, sizeof(float) * 4 * count, bounds);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        }
+    }
+    buffer->commandDirtyStart = (size_t)-1;
+    buffer->commandDirtyEnd = 0;
+    return 1;
+}
+// uploads the changed commands and issues the indirect draws of a buffer that is already bound
+static void goofy_issueIndirectDraws(GOOFY_BUFFER* buffer) {
+    if (!goofy_uploadSlotCommands(buffer)) {
+        if (goofy_countDraws(buffer) > 0) goofy_issueDraws(buffer, 1);
+        return;
+    }
+
+    size_t streamCounts[2] = {0, 0};
+    for (size_t i = 0; i < buffer->meshCount; ++i) {
+        size_t half = buffer->indexTypes[i] == GL_UNSIGNED_INT;
+        GOOFY_DRAW_COMMAND* command = &buffer->commands[half * buffer->commandCapacity + buffer->slotCount + streamCounts[half]++];
+        command->count = (GLuint)buffer->indexCounts[i];
+        command->instanceCount = buffer->instanceCounts[i];
+        command->firstIndex = (GLuint)(half ? buffer->indexOffsets[i] / 2 : buffer->indexOffsets[i]);
+        command->baseVertex = (GLint)buffer->vertexOffsets[i];
+        command->baseInstance = buffer->baseInstances[i];
+    }
+    for (size_t half = 0; half < 2; ++half) {
+        if (streamCounts[half] == 0) continue;
+        size_t first = half * buffer->commandCapacity + buffer->slotCount;
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, sizeof(GOOFY_DRAW_COMMAND) * first,
+                        sizeof(GOOFY_DRAW_COMMAND) * streamCounts[half], buffer->commands + first);
+        goofy_countUpload(buffer, 0, 0, sizeof(GOOFY_DRAW_COMMAND) * streamCounts[half]);
+    }
+
+    for (size_t half = 0; half < 2; ++half) {
+        size_t drawCount = buffer->slotCount + streamCounts[half];
+        if (drawCount == 0) continue;
+        glMultiDrawElementsIndirect(GL_TRIANGLES, half ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT,
+                                    (const void*)(sizeof(GOOFY_DRAW_COMMAND) * half * buffer->commandCapacity), (GLsizei)drawCount, 0);
+        goofy_countDrawCall(buffer, drawCount);
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+void goofy_drawAllMeshesIndirect(GOOFY_BUFFER* buffer, GLuint shaderProgram,GOOFY_TEXTURE_ARRAY* textureArray) {
+    if (buffer->slotCount + buffer->meshCount == 0) return;
+
+    GOOFY_ZONE_BEGIN("goofy_drawAllMeshesIndirect");
+    uint64_t start = goofy_statsNow();
+    goofy_beginBufferTiming("goofy_drawAllMeshesIndirect", buffer);
+    goofy_bindForDraw(buffer, shaderProgram, textureArray);
+    goofy_issueIndirectDraws(buffer);
+    goofy_finishDraw(buffer);
+    goofy_endBufferTiming();
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    goofy_recordLatency(&goofy_stats.drawAllMeshes, start);
+    GOOFY_ZONE_END();
+}
+// one thread per slot, visible slots get their command and draw data appended to the list of their index type
+static const char* goofy_cullShaderSource =
+    "#version 430\n"
+    "layout(local_size_x = 64) in;\n"
+    "struct Command { uint count; uint instanceCount; uint firstIndex; int baseVertex; uint baseInstance; };\n"
+    "struct Draw { mat4 transform; vec3 tint; int texIndex; vec4 positionScale; vec4 positionOffset; };\n"
+    "layout(std430, binding = 0) readonly buffer Bounds { vec4 bounds[]; };\n"
+    "layout(std430, binding = 1) readonly buffer Commands { Command commands[]; };\n"
+    "layout(std430, binding = 2) readonly buffer Draws { uint slotCount; Draw draws[]; };\n"
+    "layout(std430, binding = 3) buffer Culled16 { uint count16; Draw draws16[]; };\n"
+    "layout(std430, binding = 4) buffer Culled32 { uint count32; Draw draws32[]; };\n"
+    "layout(std430, binding = 5) writeonly buffer CulledCommands { Command culled[]; };\n"
+    "uniform vec4 planes[6];\n"
+    "uniform uint capacity;\n"
+    "void main() {\n"
+    "    uint slot = gl_GlobalInvocationID.x;\n"
+    "    if (slot >= slotCount) return;\n"
+    "    uint side = commands[slot].instanceCount != 0u ? 0u : 1u;\n"
+    "    Command command = commands[side * capacity + slot];\n"
+    "    if (command.instanceCount == 0u) return;\n" // hidden or released
+    "    mat4 model = draws[slot].transform;\n"
+    "    vec3 center = (model * vec4(bounds[slot].xyz, 1.0)).xyz;\n"
+    "    float scale = max(dot(model[0].xyz, model[0].xyz), max(dot(model[1].xyz, model[1].xyz), dot(model[2].xyz, model[2].xyz)));\n"
+    "    float radius = bounds[slot].w * sqrt(scale);\n"
+    "    for (int i = 0; i < 6; ++i) {\n"
+    "        if (dot(planes[i].xyz, center) + planes[i].w < -radius) return;\n"
+    "    }\n"
+    "    if (side == 0u) {\n"
+    "        uint index = atomicAdd(count16, 1u);\n"
+    "        culled[index] = command;\n"
+    "        draws16[index] = draws[slot];\n"
+    "    } else {\n"
+    "        uint index = atomicAdd(count32, 1u);\n"
+    "        culled[capacity + index] = command;\n"
+    "        draws32[index] = draws[slot];\n"
+    "    }\n"
+    "}\n";
+static char goofy_initCullProgram(void) {
+    if (goofy_cullProgram) return 1;
+    if (!goofy_hasGLVersion(4, 3)) return 0;
+    goofy_cullProgram = create_compute_program(goofy_cullShaderSource);
+    if (goofy_cullProgram == 0) return 0;
+    GOOFY_SHADER* shader = goofy_getShader(goofy_cullProgram);
+    goofy_cullPlanesUniform = goofy_findUniform(shader, "planes");
+    goofy_cullCapacityUniform = goofy_findUniform(shader, "capacity");
+    return 1;
+}
+static char goofy_hasIndirectCount(void) {
+#ifdef GL_VERSION_4_6
+    if (GLAD_GL_VERSION_4_6) return 1;
+#endif
+#ifdef GL_ARB_indirect_parameters
+    if (GLAD_GL_ARB_indirect_parameters) return 1;
+#endif
+    return 0;
+}
+// extracts the 6 frustum planes (Gribb/Hartmann) of a column major matrix, normalized so distances are in world units
+static void goofy_frustumPlanes(const float* m, float* planes) {
+    for (int i = 0; i < 6; ++i) {
+        int row = i / 2;
+        float sign = (i & 1) ? -1.0f : 1.0f;
+        float* plane = planes + i * 4;
+        for (int c = 0; c < 4; ++c) {
+            plane[c] = m[c * 4 + 3] + sign * m[c * 4 + row];
+        }
+        float length = sqrtf(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        if (length > 0.0f) {
+            for (int c = 0; c < 4; ++c) plane[c] /= length;
+        }
+    }
+}
+// runs the culling shader over the slots, the commands and draw data have to be uploaded already
+static void goofy_cullSlots(GOOFY_BUFFER* buffer, const float* viewProjection) {
+    float planes[24];
+    goofy_frustumPlanes(viewProjection, planes);
+    GOOFY_SHADER* shader = goofy_getShader(goofy_cullProgram);
+    goofy_setUniformArray(shader, goofy_cullPlanesUniform, planes, 6);
+    GLuint capacity = (GLuint)buffer->culledCapacity;
+    goofy_setUniformArray(shader, goofy_cullCapacityUniform, &capacity, 1);
+
+    // reset both counters, without a draw count buffer the unused commands have to be empty too
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer->culledDrawBuffer);
+    glClearBufferSubData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, 0, sizeof(GLuint), GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+    glClearBufferSubData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, buffer->culledRegionSize, sizeof(GLuint), GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+    if (!goofy_hasIndirectCount()) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer->culledCommandBuffer);
+        glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buffer->boundsBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, buffer->indirectBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, buffer->drawDataBuffer);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 3, buffer->culledDrawBuffer, 0, (GLsizeiptr)buffer->culledRegionSize);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 4, buffer->culledDrawBuffer, (GLintptr)buffer->culledRegionSize, (GLsizeiptr)buffer->culledRegionSize);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, buffer->culledCommandBuffer);
+
+    GLint previousProgram = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+    glUseProgram(goofy_cullProgram);
+    goofy_countBinds(buffer, 2); // and back to the previous program below
+    glDispatchCompute((GLuint)((buffer->slotCount + 63) / 64), 1, 1);
+    glUseProgram((GLuint)previousProgram);
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+}
+// draws the visible slots of one index type
+static void goofy_drawCulledSlots(GOOFY_BUFFER* buffer, size_t half) {
+    GLenum type = half ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+    const void* commands = (const void*)(sizeof(GOOFY_DRAW_COMMAND) * half * buffer->culledCapacity);
+    GLintptr countOffset = (GLintptr)(half * buffer->culledRegionSize);
+    goofy_countDrawCall(buffer, buffer->slotCount); // how many of them draw only the GPU knows
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, GOOFY_DRAW_BINDING, buffer->culledDrawBuffer, countOffset, (GLsizeiptr)buffer->culledRegionSize);
+#ifdef GL_VERSION_4_6
+    if (GLAD_GL_VERSION_4_6) {
+        glBindBuffer(GL_PARAMETER_BUFFER, buffer->culledDrawBuffer);
+        glMultiDrawElementsIndirectCount(GL_TRIANGLES, type, commands, countOffset, (GLsizei)buffer->slotCount, 0);
+        glBindBuffer(GL_PARAMETER_BUFFER, 0);
+        return;
+    }
+#endif
+#ifdef GL_ARB_indirect_parameters
+    if (GLAD_GL_ARB_indirect_parameters) {
+        glBindBuffer(GL_PARAMETER_BUFFER_ARB, buffer->culledDrawBuffer);
+        glMultiDrawElementsIndirectCountARB(GL_TRIANGLES, type, commands, countOffset, (GLsizei)buffer->slotCount, 0);
+        glBindBuffer(GL_PARAMETER_BUFFER_ARB, 0);
+        return;
+    }
+#endif
+    // the commands after the visible ones were cleared, they draw nothing
+    glMultiDrawElementsIndirect(GL_TRIANGLES, type, commands, (GLsizei)buffer->slotCount, 0);
+}
+void goofy_drawAllMeshesCulled(GOOFY_BUFFER* buffer, GLuint shaderProgram,GOOFY_TEXTURE_ARRAY* textureArray, const float* viewProjection) {
+    if (buffer->slotCount + buffer->meshCount == 0) return;
+    if (!goofy_initCullProgram() || buffer->drawDataBuffer == 0) {
+        goofy_drawAllMeshesIndirect(buffer, shaderProgram, textureArray);
+        return;
+    }
+    if (buffer->boundsBuffer == 0) {
+        glGenBuffers(1, &buffer->boundsBuffer);
+        glGenBuffers(1, &buffer->culledCommandBuffer);
+        glGenBuffers(1, &buffer->culledDrawBuffer);
+        buffer->culledCapacity = 0; // sized by goofy_uploadSlotCommands
+    }
+
+    GOOFY_ZONE_BEGIN("goofy_drawAllMeshesCulled");
+    uint64_t start = goofy_statsNow();
+    goofy_beginBufferTiming("goofy_drawAllMeshesCulled", buffer); // includes the culling dispatch
+    goofy_bindForDraw(buffer, shaderProgram, textureArray);
+    if (!goofy_uploadSlotCommands(buffer)) {
+        if (goofy_countDraws(buffer) > 0) goofy_issueDraws(buffer, 1);
+    } else {
+        if (buffer->slotCount > 0) {
+            goofy_cullSlots(buffer, viewProjection);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer->culledCommandBuffer);
+            goofy_drawCulledSlots(buffer, 0);
+            goofy_drawCulledSlots(buffer, 1);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        }
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, GOOFY_DRAW_BINDING, buffer->culledDrawBuffer,
+                          (GLintptr)(buffer->culledRegionSize * 2), GOOFY_DRAW_DATA_HEADER);
+        goofy_issueDraws(buffer, 0);
+    }
+    goofy_finishDraw(buffer);
+    goofy_endBufferTiming();
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    goofy_recordLatency(&goofy_stats.drawAllMeshes, start);
+    GOOFY_ZONE_END();
+}
+void goofy_terminate() {
+    for (short i = 0; i < goofy_trashRegistryCount; ++i) {
+        if (goofy_trashRegistry[i]) {
+            goofy_freeTrashBatch(goofy_trashRegistry[i]);
+            goofy_trashRegistry[i] = NULL;
+        }
+    }
+    goofy_trashRegistryCount = 0;
+    if (goofy_cullProgram) {
+        goofy_deleteShader(goofy_cullProgram);
+        goofy_cullProgram = 0;
+    }
+    while (goofy_shaderRegistryCount > 0) {
+        goofy_freeShaderTable(goofy_shaderRegistry[--goofy_shaderRegistryCount]);
+    }
+    free(goofy_shaderRegistry);
+    goofy_shaderRegistry = NULL;
+    goofy_shaderRegistryCapacity = 0;
+#ifdef GOOFY_TRACE
+    GOOFY_TRACE_RING* ring = atomic_exchange(&goofy_traceRings, NULL);
+    atomic_fetch_add(&goofy_traceGeneration, 1);
+    while (ring) {
+        GOOFY_TRACE_RING* next = ring->next;
+        free(ring);
+        ring = next;
+    }
+#endif
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    glBindVertexArray(0);
+}
+
+// RETAINED-MESH functions
+// finds a free slot entry, reusing released ones with enough space first
+// indexCount is in 16 bit units here
+static int goofy_allocSlot(GOOFY_BUFFER* buffer, size_t vertexCount, size_t indexCount) {
+    for (size_t i = 0; i < buffer->slotCount; ++i) {
+        GOOFY_MESH_SLOT* slot = &buffer->slots[i];
+        if (!slot->used && slot->vertexCapacity >= vertexCount && slot->indexCapacity >= indexCount) {
+            slot->used = 1;
+            return (int)i;
+        }
+    }
+
+    // nothing to reuse, take new space from the top of the stream area
+    if (!goofy_slotFits(buffer, vertexCount, indexCount) && !goofy_growBuffer(buffer, vertexCount, indexCount, 1)) {
+        return -1;
+    }
+
+    size_t index = buffer->slotCount;
+    for (size_t i = 0; i < buffer->slotCount; ++i) {
+        if (!buffer->slots[i].used && buffer->slots[i].vertexCapacity == 0 && buffer->slots[i].indexCapacity == 0) {
+            index = i;
+            break;
+        }
+    }
+    if (index == buffer->slotCount) {
+        if (buffer->slotCount >= buffer->slotCapacity) {
+            size_t newCapacity = buffer->slotCapacity ? buffer->slotCapacity * 2 : 64;
+            GOOFY_MESH_SLOT* slots = realloc(buffer->slots, sizeof(GOOFY_MESH_SLOT) * newCapacity);
+            if (!slots) {
+                fprintf(stderr, "[GOOFYLIB3] Failed to allocate mesh slots\n");
+                return -1;
+            }
+            buffer->slots = slots;
+            goofy_countGrowths(buffer, 1);
+            buffer->slotCapacity = newCapacity;
+            if (!goofy_reserveDrawData(buffer, newCapacity)) return -1;
+        }
+        buffer->slotCount++;
+    }
+
+    buffer->retainedVertexBase -= vertexCount;
+    buffer->retainedIndexBase -= indexCount;
+    GOOFY_MESH_SLOT* slot = &buffer->slots[index];
+    slot->vertexOffset = buffer->retainedVertexBase;
+    slot->indexOffset = buffer->retainedIndexBase;
+    slot->vertexCapacity = vertexCount;
+    slot->indexCapacity = indexCount;
+    slot->used = 1;
+    return (int)index;
+}
+static void goofy_resetSlotDrawData(GOOFY_BUFFER* buffer, size_t slot) {
+    buffer->drawData[slot] = goofy_translationInstance(0.0f, 0.0f, 0.0f);
+    goofy_markSlotDrawData(buffer, slot);
+}
+static char goofy_isValidSlot(GOOFY_BUFFER* buffer, int slot) {
+    if (slot < 0 || (size_t)slot >= buffer->slotCount || !buffer->slots[slot].used) {
+        fprintf(stderr, "[GOOFYLIB3] Invalid mesh slot %d\n", slot);
+        return 0;
+    }
+    return 1;
+}
+int goofy_addMeshSlot(GOOFY_BUFFER* buffer, GOOFY_MESH* mesh) {
+    GLenum indexType = goofy_indexType(mesh->vertexCount);
+    int index = goofy_allocSlot(buffer, mesh->vertexCount, goofy_indexUnits(mesh->indexCount, indexType));
+    if (index < 0) {
+        fprintf(stderr, "[GOOFYLIB3] Buffer is full, could not add mesh slot\n");
+        return -1;
+    }
+    GOOFY_MESH_SLOT* slot = &buffer->slots[index];
+    slot->vertexCount = mesh->vertexCount;
+    slot->indexCount = mesh->indexCount;
+    slot->indexType = indexType;
+    slot->visible = 1;
+    memcpy(slot->bounds, goofy_meshBounds(mesh)->sphere, sizeof(slot->bounds));
+    slot->mesh = mesh;
+    slot->meshVersion = mesh->version;
+    goofy_markSlotCommand(buffer, (size_t)index);
+    goofy_resetSlotDrawData(buffer, (size_t)index);
+    goofy_setPositionDecode(&buffer->drawData[index], goofy_packingBox(buffer, mesh));
+
+    if (buffer->frameCount > 1) goofy_waitAllFrames(buffer);
+    goofy_countMeshes(buffer, 1);
+    goofy_writeMesh(buffer, mesh, slot->vertexOffset, slot->indexOffset, indexType);
+    goofy_cleanMesh(mesh);
+    return index;
+}
+// uploads only the dirty ranges of a mesh the slot already holds an older version of, returns 0 if it has to be a full upload
+static char goofy_updateSlotRanges(GOOFY_BUFFER* buffer, GOOFY_MESH_SLOT* slot, GOOFY_MESH* mesh) {
+    if (mesh->version == 0 || slot->mesh != mesh) return 0;
+    if (slot->meshVersion == mesh->version) return 1; // nothing changed
+    if (slot->meshVersion != mesh->dirtySince || slot->vertexCount != mesh->vertexCount || slot->indexCount != mesh->indexCount) return 0;
+    if (mesh->dirtyVertexEnd > mesh->vertexCount || mesh->dirtyIndexEnd > mesh->indexCount) return 0;
+
+    // packed positions are relative to the box, when it changed every vertex has to go up again
+    const GOOFY_BOUNDS* box = mesh->dirtyVertexStart < mesh->dirtyVertexEnd ? goofy_packingBox(buffer, mesh) : NULL;
+    if (box && !goofy_sameDecode(&buffer->drawData[slot - buffer->slots], box)) return 0;
+
+    if (buffer->frameCount > 1) goofy_waitAllFrames(buffer);
+    if (mesh->dirtyVertexStart < mesh->dirtyVertexEnd) {
+        goofy_writeVertices(buffer, mesh->vertices + mesh->dirtyVertexStart, mesh->dirtyVertexEnd - mesh->dirtyVertexStart, 0, box,
+                            slot->vertexOffset + mesh->dirtyVertexStart);
+        // moved vertices can move the sphere, even when the caller already refreshed the bounds themselves
+        memcpy(slot->bounds, goofy_meshBounds(mesh)->sphere, sizeof(slot->bounds));
+        goofy_markSlotCommand(buffer, (size_t)(slot - buffer->slots)); // bounds go up with the command
+    }
+    if (mesh->dirtyIndexStart < mesh->dirtyIndexEnd) {
+        size_t unitsPerIndex = slot->indexType == GL_UNSIGNED_INT ? 2 : 1;
+        goofy_writeIndices(buffer, mesh->indices + mesh->dirtyIndexStart, mesh->dirtyIndexEnd - mesh->dirtyIndexStart, slot->indexType,
+                           slot->indexOffset + mesh->dirtyIndexStart * unitsPerIndex);
+    }
+    goofy_countMeshes(buffer, 1);
+    slot->meshVersion = mesh->version;
+    goofy_cleanMesh(mesh);
+    return 1;
+}
+void goofy_updateMeshSlot(GOOFY_BUFFER* buffer, int slot, GOOFY_MESH* mesh) {
+    if (!goofy_isValidSlot(buffer, slot)) return;
+    if (goofy_updateSlotRanges(buffer, &buffer->slots[slot], mesh)) return;
+
+    GOOFY_MESH_SLOT* current = &buffer->slots[slot];
+    GLenum indexType = goofy_indexType(mesh->vertexCount);
+    size_t indexUnits = goofy_indexUnits(mesh->indexCount, indexType);
+    if (mesh->vertexCount > current->vertexCapacity || indexUnits > current->indexCapacity) {
+        // too big for its space, move it somewhere else and leave the old space as a released slot
+        int moved = goofy_allocSlot(buffer, mesh->vertexCount, indexUnits);
+        if (moved < 0) {
+            fprintf(stderr, "[GOOFYLIB3] Buffer is full, could not update mesh slot %d\n", slot);
+            return;
+        }
+        current = &buffer->slots[slot]; // slots may have been reallocated
+        GOOFY_MESH_SLOT old = *current;
+        *current = buffer->slots[moved];
+        buffer->slots[moved] = old;
+        buffer->slots[moved].used = 0;
+        current->visible = old.visible;
+        goofy_markSlotCommand(buffer, (size_t)moved);
+    }
+    current->vertexCount = mesh->vertexCount;
+    current->indexCount = mesh->indexCount;
+    current->indexType = indexType;
+    memcpy(current->bounds, goofy_meshBounds(mesh)->sphere, sizeof(current->bounds));
+    current->mesh = mesh;
+    current->meshVersion = mesh->version;
+    goofy_markSlotCommand(buffer, (size_t)slot);
+    goofy_setPositionDecode(&buffer->drawData[slot], goofy_packingBox(buffer, mesh));
+    goofy_markSlotDrawData(buffer, (size_t)slot);
+
+    if (buffer->frameCount > 1) goofy_waitAllFrames(buffer);
+    goofy_countMeshes(buffer, 1);
+    goofy_writeMesh(buffer, mesh, current->vertexOffset, current->indexOffset, indexType);
+    goofy_cleanMesh(mesh);
+}
+void goofy_setMeshSlotVisible(GOOFY_BUFFER* buffer, int slot, char visible) {
+    if (!goofy_isValidSlot(buffer, slot)) return;
+    buffer->slots[slot].visible = visible;
+    goofy_markSlotCommand(buffer, (size_t)slot);
+}
+void goofy_removeMeshSlot(GOOFY_BUFFER* buffer, int slot) {
+    if (!goofy_isValidSlot(buffer, slot)) return;
+
+    GOOFY_MESH_SLOT* removed = &buffer->slots[slot];
+    removed->used = 0;
+    removed->visible = 0;
+    removed->vertexCount = 0;
+    removed->indexCount = 0;
+    removed->mesh = NULL;
+    goofy_markSlotCommand(buffer, (size_t)slot);
+    if (removed->vertexOffset == buffer->retainedVertexBase && removed->indexOffset == buffer->retainedIndexBase) {
+        // lowest retained mesh, give the space back to the stream area
+        buffer->retainedVertexBase += removed->vertexCapacity;
+        buffer->retainedIndexBase += removed->indexCapacity;
+        removed->vertexCapacity = 0;
+        removed->indexCapacity = 0;
+    }
+}
+void goofy_setMeshSlotTransform(GOOFY_BUFFER* buffer, int slot, const float* transform) {
+    if (!goofy_isValidSlot(buffer, slot)) return;
+    memcpy(buffer->drawData[slot].transform, transform, sizeof(float) * 16);
+    goofy_markSlotDrawData(buffer, (size_t)slot);
+}
+void goofy_setMeshSlotColor(GOOFY_BUFFER* buffer, int slot, float r, float g, float b) {
+    if (!goofy_isValidSlot(buffer, slot)) return;
+    buffer->drawData[slot].tint[0] = r;
+    buffer->drawData[slot].tint[1] = g;
+    buffer->drawData[slot].tint[2] = b;
+    goofy_markSlotDrawData(buffer, (size_t)slot);
+}
+void goofy_setMeshSlotTexture(GOOFY_BUFFER* buffer, int slot, int texIndex) {
+    if (!goofy_isValidSlot(buffer, slot)) return;
+    buffer->drawData[slot].texIndex = texIndex;
+    goofy_markSlotDrawData(buffer, (size_t)slot);
+}
+
+// RENDER-QUEUE functions
+GOOFY_RENDER_QUEUE goofy_initRenderQueue(size_t capacity) {
+    GOOFY_RENDER_QUEUE queue;
+    if (capacity == 0) capacity = 64;
+    queue.items = (GOOFY_QUEUE_ITEM*)malloc(sizeof(GOOFY_QUEUE_ITEM) * capacity);
+    queue.sorted = (GOOFY_QUEUE_ITEM*)malloc(sizeof(GOOFY_QUEUE_ITEM) * capacity);
+    queue.count = 0;
+    queue.capacity = capacity;
+    if (!queue.items || !queue.sorted) {
+        fprintf(stderr, "[GOOFYLIB3] Failed to allocate render queue\n");
+        free(queue.items);
+        free(queue.sorted);
+        queue.items = NULL;
+        queue.sorted = NULL;
+        queue.capacity = 0;
+    }
+    return queue;
+}
+// maps a float to 16 bits that sort the same way as the float
+static uint64_t goofy_depthBits(float depth) {
+    uint32_t bits;
+    memcpy(&bits, &depth, sizeof(bits));
+    bits = (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+    return bits >> 16;
+}
+static void goofy_queueItem(GOOFY_RENDER_QUEUE* queue, GOOFY_BUFFER* buffer, GLuint shaderProgram, GOOFY_TEXTURE_ARRAY* textureArray, float depth, char indirect) {
+    if (queue->count >= queue->capacity) {
+        size_t newCapacity = queue->capacity ? queue->capacity * 2 : 64;
+        GOOFY_QUEUE_ITEM* items = realloc(queue->items, sizeof(GOOFY_QUEUE_ITEM) * newCapacity);
+        if (items) queue->items = items;
+        GOOFY_QUEUE_ITEM* sorted = realloc(queue->sorted, sizeof(GOOFY_QUEUE_ITEM) * newCapacity);
+        if (sorted) queue->sorted = sorted;
+        if (!items || !sorted) {
+            fprintf(stderr, "[GOOFYLIB3] Render queue is full, draw skipped\n");
+            return;
+        }
+        queue->capacity = newCapacity;
+        goofy_countGrowths(NULL, 2);
+    }
+    // program switches cost the most so they are the top bits, then textures, then VAOs, then depth (front to back)
+    GOOFY_QUEUE_ITEM* item = &queue->items[queue->count++];
+    item->key = ((uint64_t)(shaderProgram & 0xFFFF) << 48) |
+                ((uint64_t)(textureArray->textureArray & 0xFFFF) << 32) |
+                ((uint64_t)(buffer->VAO & 0xFFFF) << 16) |
+                goofy_depthBits(depth);
+    item->buffer = buffer;
+    item->shaderProgram = shaderProgram;
+    item->textureArray = textureArray;
+    item->indirect = indirect;
+}
+void goofy_queueBuffer(GOOFY_RENDER_QUEUE* queue, GOOFY_BUFFER* buffer, GLuint shaderProgram, GOOFY_TEXTURE_ARRAY* textureArray, float depth) {
+    goofy_queueItem(queue, buffer, shaderProgram, textureArray, depth, 0);
+}
+void goofy_queueBufferIndirect(GOOFY_RENDER_QUEUE* queue, GOOFY_BUFFER* buffer, GLuint shaderProgram, GOOFY_TEXTURE_ARRAY* textureArray, float depth) {
+    goofy_queueItem(queue, buffer, shaderProgram, textureArray, depth, 1);
+}
+// LSD radix sort on the keys, 8 bits per pass, passes where every key has the same byte are skipped. Returns the sorted array
+static GOOFY_QUEUE_ITEM* goofy_sortQueue(GOOFY_RENDER_QUEUE* queue) {
+    GOOFY_QUEUE_ITEM* src = queue->items;
+    GOOFY_QUEUE_ITEM* dst = queue->sorted;
+    size_t counts[256];
+    for (int shift = 0; shift < 64; shift += 8) {
+        memset(counts, 0, sizeof(counts));
+        for (size_t i = 0; i < queue->count; ++i) {
+            counts[(src[i].key >> shift) & 0xFF]++;
+        }
+        if (counts[(src[0].key >> shift) & 0xFF] == queue->count) continue;
+
+        size_t total = 0;
+        for (int b = 0; b < 256; ++b) {
+            size_t count = counts[b];
+            counts[b] = total;
+            total += count;
+        }
+        for (size_t i = 0; i < queue->count; ++i) {
+            dst[counts[(src[i].key >> shift) & 0xFF]++] = src[i];
+        }
+        GOOFY_QUEUE_ITEM* swap = src;
+        src = dst;
+        dst = swap;
+    }
+    return src;
+}
+void goofy_drawRenderQueue(GOOFY_RENDER_QUEUE* queue) {
+    if (queue->count == 0) return;
+    GOOFY_ZONE_BEGIN("goofy_drawRenderQueue");
+    uint64_t start = goofy_statsNow();
+    GOOFY_QUEUE_ITEM* items = goofy_sortQueue(queue);
+
+    // only touch the state that actually changes between two draws
+    GLuint program = 0, vao = 0, texture = 0;
+    char first = 1;
+    glActiveTexture(GL_TEXTURE0);
+    for (size_t i = 0; i < queue->count; ++i) {
+        GOOFY_QUEUE_ITEM* item = &items[i];
+        GOOFY_BUFFER* buffer = item->buffer;
+        if (first || item->shaderProgram != program) {
+            program = item->shaderProgram;
+            glUseProgram(program);
+            goofy_countBinds(buffer, 1);
+            goofy_setTextureUnit(program);
+        }
+        if (first || buffer->VAO != vao) {
+            vao = buffer->VAO;
+            glBindVertexArray(vao);
+            goofy_countBinds(buffer, 1);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer->EBO);
+        }
+        goofy_bindDrawData(buffer); // every buffer has its own, cheap when nothing changed
+        if (first || item->textureArray->textureArray != texture) {
+            texture = item->textureArray->textureArray;
+            glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+            goofy_countBinds(buffer, 1);
+        }
+        first = 0;
+
+        // the state changes above are left out, the scope is only the draws of this buffer
+        goofy_beginBufferTiming(item->indirect ? "goofy_queueBufferIndirect" : "goofy_queueBuffer", buffer);
+        if (item->indirect) {
+            goofy_issueIndirectDraws(buffer);
+        } else if (goofy_countDraws(buffer) > 0) {
+            goofy_issueDraws(buffer, 1);
+        }
+        goofy_finishDraw(buffer);
+        goofy_endBufferTiming();
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    queue->count = 0;
+    goofy_recordLatency(&goofy_stats.drawAllMeshes, start);
+    GOOFY_ZONE_END();
+}
+void goofy_freeRenderQueue(GOOFY_RENDER_QUEUE* queue) {
+    free(queue->items);
+    free(queue->sorted);
+    queue->items = NULL;
+    queue->sorted = NULL;
+    queue->count = 0;
+    queue->capacity = 0;
+}
+
+// UNIFORM-BUFFER functions
+GOOFY_UNIFORM_BUFFER goofy_initUniformBuffer(size_t batchSize, unsigned int frameCount) {
+    GOOFY_UNIFORM_BUFFER uniforms;
+    memset(&uniforms, 0, sizeof(uniforms));
+    if (frameCount == 0) frameCount = 1;
+
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    uniforms.alignment = alignment > 0 ? (size_t)alignment : 256;
+    uniforms.batchSize = (batchSize + uniforms.alignment - 1) / uniforms.alignment * uniforms.alignment;
+    uniforms.frameCount = frameCount;
+
+    glGenBuffers(1, &uniforms.frameUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, uniforms.frameUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(GOOFY_FRAME_CONSTANTS), NULL, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, GOOFY_FRAME_BINDING, uniforms.frameUBO);
+
+    GLsizeiptr ringSize = (GLsizeiptr)(uniforms.batchSize * frameCount);
+    glGenBuffers(1, &uniforms.batchUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, uniforms.batchUBO);
+    if (frameCount > 1 && goofy_hasGLVersion(4, 4)) {
+        GLbitfield persistentFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_UNIFORM_BUFFER, ringSize, NULL, persistentFlags);
+        uniforms.mappedBatches = (unsigned char*)glMapBufferRange(GL_UNIFORM_BUFFER, 0, ringSize, persistentFlags);
+        uniforms.fences = (GLsync*)calloc(frameCount, sizeof(GLsync));
+        if (!uniforms.mappedBatches || !uniforms.fences) {
+            printf("[GOOFYLIB3] Failed to map uniform ring buffer\n");
+        }
+    } else {
+        glBufferData(GL_UNIFORM_BUFFER, ringSize, NULL, GL_DYNAMIC_DRAW);
+    }
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    printf("[GOOFYLIB3] Successfully initialized uniform buffers (%zu batch bytes x %u regions)\n", uniforms.batchSize, frameCount);
+    return uniforms;
+}
+void goofy_setFrameConstants(GOOFY_UNIFORM_BUFFER* uniforms, const GOOFY_FRAME_CONSTANTS* constants) {
+    glBindBuffer(GL_UNIFORM_BUFFER, uniforms->frameUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(GOOFY_FRAME_CONSTANTS), constants);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, GOOFY_FRAME_BINDING, uniforms->frameUBO);
+}
+char goofy_pushBatchConstants(GOOFY_UNIFORM_BUFFER* uniforms, const void* data, size_t size) {
+    if (uniforms->batchOffset + size > uniforms->batchSize) {
+        fprintf(stderr, "[GOOFYLIB3] Uniform ring region is full, batch constants skipped\n");
+        return 0;
+    }
+    if (uniforms->fences && !uniforms->frameReady) {
+        GLsync fence = uniforms->fences[uniforms->currentFrame];
+        if (fence) {
+            GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+            while (result == GL_TIMEOUT_EXPIRED) {
+                result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+            }
+            glDeleteSync(fence);
+            uniforms->fences[uniforms->currentFrame] = NULL;
+        }
+        uniforms->frameReady = 1;
+    }
+
+    size_t offset = uniforms->currentFrame * uniforms->batchSize + uniforms->batchOffset;
+    if (uniforms->mappedBatches) {
+        memcpy(uniforms->mappedBatches + offset, data, size);
+    } else {
+        glBindBuffer(GL_UNIFORM_BUFFER, uniforms->batchUBO);
+        glBufferSubData(GL_UNIFORM_BUFFER, (GLintptr)offset, (GLsizeiptr)size, data);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+    glBindBufferRange(GL_UNIFORM_BUFFER, GOOFY_BATCH_BINDING, uniforms->batchUBO, (GLintptr)offset, (GLsizeiptr)size);
+    // the next block has to start on the alignment the driver wants
+    uniforms->batchOffset += (size + uniforms->alignment - 1) / uniforms->alignment * uniforms->alignment;
+    return 1;
+}
+void goofy_endUniformFrame(GOOFY_UNIFORM_BUFFER* uniforms) {
+    if (uniforms->fences) {
+        if (uniforms->fences[uniforms->currentFrame]) glDeleteSync(uniforms->fences[uniforms->currentFrame]);
+        uniforms->fences[uniforms->currentFrame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    uniforms->currentFrame = (uniforms->currentFrame + 1) % uniforms->frameCount;
+    uniforms->batchOffset = 0;
+    uniforms->frameReady = 0;
+}
+void goofy_freeUniformBuffer(GOOFY_UNIFORM_BUFFER* uniforms) {
+    if (uniforms->fences) {
+        for (unsigned int i = 0; i < uniforms->frameCount; ++i) {
+            if (uniforms->fences[i]) glDeleteSync(uniforms->fences[i]);
+        }
+        free(uniforms->fences);
+        uniforms->fences = NULL;
+    }
+    glDeleteBuffers(1, &uniforms->frameUBO); // deleting unmaps the ring too
+    glDeleteBuffers(1, &uniforms->batchUBO);
+    uniforms->frameUBO = 0;
+    uniforms->batchUBO = 0;
+    uniforms->mappedBatches = NULL;
+}
+
+// GPU-TIMING functions
+GOOFY_GPU_TIMER goofy_initGpuTimer(size_t maxScopes, unsigned int frameCount) {
+    GOOFY_GPU_TIMER timer;
+    memset(&timer, 0, sizeof(timer));
+    if (frameCount < 2) frameCount = 2; // one region has to be in flight while the other gets read
+    if (maxScopes == 0) maxScopes = 1;
+    if (!goofy_hasGLVersion(3, 3)) {
+        fprintf(stderr, "[GOOFYLIB3] GPU timing needs OpenGL 3.3 (timer queries)\n");
+        return timer;
+    }
+
+    size_t pairs = (maxScopes + 1) * frameCount;
+    timer.queries = (GLuint*)malloc(pairs * 2 * sizeof(GLuint));
+    timer.pending = (GOOFY_GPU_SCOPE_TIME*)calloc(pairs, sizeof(GOOFY_GPU_SCOPE_TIME));
+    timer.pendingCounts = (size_t*)calloc(frameCount, sizeof(size_t));
+    timer.regionFrames = (unsigned long long*)calloc(frameCount, sizeof(unsigned long long));
+    timer.openScopes = (size_t*)malloc(maxScopes * sizeof(size_t));
+    timer.report.scopes = (GOOFY_GPU_SCOPE_TIME*)malloc(maxScopes * sizeof(GOOFY_GPU_SCOPE_TIME));
+    if (!timer.queries || !timer.pending || !timer.pendingCounts || !timer.regionFrames || !timer.openScopes || !timer.report.scopes) {
+        printf("[GOOFYLIB3] Failed to allocate GPU timer\n");
+        free(timer.queries);
+        free(timer.pending);
+        free(timer.pendingCounts);
+        free(timer.regionFrames);
+        free(timer.openScopes);
+        free(timer.report.scopes);
+        memset(&timer, 0, sizeof(timer));
+        return timer;
+    }
+    glGenQueries((GLsizei)(pairs * 2), timer.queries);
+    timer.scopeCapacity = maxScopes;
+    timer.frameCount = frameCount;
+    printf("[GOOFYLIB3] Successfully initialized GPU timer (%zu scopes x %u frames)\n", maxScopes, frameCount);
+    return timer;
+}
+// reads a finished region into the report, returns 0 without waiting if the GPU isnt there yet
+static char goofy_collectGpuFrame(GOOFY_GPU_TIMER* timer, unsigned int region) {
+    size_t first = region * (timer->scopeCapacity + 1);
+    GLuint* queries = timer->queries + first * 2;
+    GLuint available = 0;
+    // the frame end is the last timestamp of the region, when it is there the others are too
+    glGetQueryObjectuiv(queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) return 0;
+
+    GLuint64 start = 0, end = 0;
+    glGetQueryObjectui64v(queries[0], GL_QUERY_RESULT, &start);
+    glGetQueryObjectui64v(queries[1], GL_QUERY_RESULT, &end);
+    GOOFY_GPU_FRAME_REPORT* report = &timer->report;
+    report->frame = timer->regionFrames[region];
+    report->milliseconds = (double)(end - start) / 1000000.0;
+    report->scopeCount = 0;
+
+    for (size_t i = 1; i < timer->pendingCounts[region]; ++i) {
+        GOOFY_GPU_SCOPE_TIME* scope = &timer->pending[first + i];
+        glGetQueryObjectui64v(queries[i * 2], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+        double milliseconds = end > start ? (double)(end - start) / 1000000.0 : 0.0;
+
+        // a scope used in a loop shows up once, a frame only has a few so a linear search is fine
+        GOOFY_GPU_SCOPE_TIME* merged = NULL;
+        for (size_t j = 0; j < report->scopeCount; ++j) {
+            GOOFY_GPU_SCOPE_TIME* existing = &report->scopes[j];
+            if (existing->buffer == scope->buffer && existing->depth == scope->depth && strcmp(existing->name, scope->name) == 0) {
+                merged = existing;
+                break;
+            }
+        }
+        if (merged) {
+            merged->calls++;
+            merged->milliseconds += milliseconds;
+        } else {
+            merged = &report->scopes[report->scopeCount++];
+            *merged = *scope;
+            merged->milliseconds = milliseconds;
+        }
+    }
+    timer->reportReady = 1;
+    return 1;
+}
+void goofy_beginGpuFrame(GOOFY_GPU_TIMER* timer) {
+    if (!timer->queries) return;
+    if (timer->active) goofy_endGpuFrame(timer);
+
+    unsigned int region = timer->currentFrame;
+    if (timer->pendingCounts[region] > 0 && !goofy_collectGpuFrame(timer, region)) {
+        timer->droppedFrames++; // its queries get reused, the GPU is more than frameCount frames behind
+    }
+    timer->pendingCounts[region] = 1; // pair 0 is the frame itself
+    timer->regionFrames[region] = timer->frame++;
+    timer->openCount = 0;
+    timer->droppedOpen = 0;
+    timer->active = 1;
+    glQueryCounter(timer->queries[region * (timer->scopeCapacity + 1) * 2], GL_TIMESTAMP);
+    goofy_activeGpuTimer = timer;
+}
+void goofy_beginGpuScope(GOOFY_GPU_TIMER* timer, const char* name) {
+    if (!timer->active) return;
+    goofy_openGpuScope(timer, name, NULL);
+}
+void goofy_endGpuScope(GOOFY_GPU_TIMER* timer) {
+    if (!timer->active) return;
+    goofy_closeGpuScope(timer);
+}
+void goofy_endGpuFrame(GOOFY_GPU_TIMER* timer) {
+    if (!timer->active) return;
+    while (timer->openCount > 0 || timer->droppedOpen > 0) goofy_closeGpuScope(timer);
+    glQueryCounter(timer->queries[timer->currentFrame * (timer->scopeCapacity + 1) * 2 + 1], GL_TIMESTAMP);
+    timer->active = 0;
+    if (goofy_activeGpuTimer == timer) goofy_activeGpuTimer = NULL;
+    timer->currentFrame = (timer->currentFrame + 1) % timer->frameCount;
+}
+const GOOFY_GPU_FRAME_REPORT* goofy_gpuFrameReport(const GOOFY_GPU_TIMER* timer) {
+    return timer->reportReady ? &timer->report : NULL;
+}
+void goofy_printGpuFrameReport(const GOOFY_GPU_FRAME_REPORT* report) {
+    if (!report) return;
+    printf("[GOOFYLIB3] GPU frame %llu: %.3f ms\n", report->frame, report->milliseconds);
+    for (size_t i = 0; i < report->scopeCount; ++i) {
+        const GOOFY_GPU_SCOPE_TIME* scope = &report->scopes[i];
+        printf("%*s%s", (int)(scope->depth * 2 + 2), "", scope->name);
+        if (scope->buffer) printf(" (VAO %u)", scope->buffer->VAO);
+        if (scope->calls > 1) printf(" x%u", scope->calls);
+        printf(": %.3f ms\n", scope->milliseconds);
+    }
+}
+void goofy_freeGpuTimer(GOOFY_GPU_TIMER* timer) {
+    if (goofy_activeGpuTimer == timer) goofy_activeGpuTimer = NULL;
+    if (timer->queries) glDeleteQueries((GLsizei)((timer->scopeCapacity + 1) * timer->frameCount * 2), timer->queries);
+    free(timer->queries);
+    free(timer->pending);
+    free(timer->pendingCounts);
+    free(timer->regionFrames);
+    free(timer->openScopes);
+    free(timer->report.scopes);
+    memset(timer, 0, sizeof(*timer));
+}
+
+// STATS functions
+const GOOFY_STATS* goofy_getStats(void) {
+    return &goofy_stats;
+}
+static void goofy_addCounters(GOOFY_COUNTERS* total, const GOOFY_COUNTERS* frame) {
+    total->meshesSubmitted += frame->meshesSubmitted;
+    total->meshesDropped += frame->meshesDropped;
+    total->verticesUploaded += frame->verticesUploaded;
+    total->indicesUploaded += frame->indicesUploaded;
+    total->bytesUploaded += frame->bytesUploaded;
+    total->drawCalls += frame->drawCalls;
+    total->multiDrawCommands += frame->multiDrawCommands;
+    total->stateBinds += frame->stateBinds;
+    total->textureUploads += frame->textureUploads;
+    total->mipGenerations += frame->mipGenerations;
+    total->arrayGrowths += frame->arrayGrowths;
+}
+void goofy_endStatsFrame(void) {
+    if (goofy_lastStatsFrame) goofy_recordLatency(&goofy_stats.frameTime, goofy_lastStatsFrame);
+    goofy_lastStatsFrame = goofy_statsNow();
+    goofy_addCounters(&goofy_stats.total, &goofy_stats.frame);
+    goofy_stats.lastFrame = goofy_stats.frame;
+    memset(&goofy_stats.frame, 0, sizeof(goofy_stats.frame));
+    goofy_stats.frames++;
+    if (goofy_statsDumpInterval && goofy_stats.frames % goofy_statsDumpInterval == 0) goofy_printStats();
+}
+void goofy_setStatsDumpInterval(unsigned int frames) {
+    goofy_statsDumpInterval = frames;
+}
+uint64_t goofy_histogramPercentile(const GOOFY_HISTOGRAM* histogram, double percentile) {
+    if (histogram->count == 0) return 0;
+    uint64_t target = (uint64_t)ceil((double)histogram->count * percentile / 100.0);
+    if (target == 0) target = 1;
+    uint64_t seen = 0;
+    for (unsigned int i = 0; i < GOOFY_HISTOGRAM_BUCKETS; ++i) {
+        seen += histogram->buckets[i];
+        if (seen >= target) {
+            uint64_t upper = (uint64_t)2 << i; // the bucket ends at 2^(i+1)
+            return upper < histogram->maxNanoseconds ? upper : histogram->maxNanoseconds;
+        }
+    }
+    return histogram->maxNanoseconds;
+}
+static void goofy_printCounters(const char* label, const GOOFY_COUNTERS* counters) {
+    printf("  %s: %llu meshes (%llu dropped), %llu vertices, %llu indices, %llu bytes uploaded, %llu draw calls (%llu draws), %llu binds, "
+           "%llu texture uploads, %llu mip generations, %llu array growths\n", label,
+           (unsigned long long)counters->meshesSubmitted, (unsigned long long)counters->meshesDropped, (unsigned long long)counters->verticesUploaded,
+           (unsigned long long)counters->indicesUploaded, (unsigned long long)counters->bytesUploaded,
+           (unsigned long long)counters->drawCalls, (unsigned long long)counters->multiDrawCommands,
+           (unsigned long long)counters->stateBinds, (unsigned long long)counters->textureUploads,
+           (unsigned long long)counters->mipGenerations, (unsigned long long)counters->arrayGrowths);
+}
+static void goofy_printHistogram(const char* label, const GOOFY_HISTOGRAM* histogram) {
+    if (histogram->count == 0) return;
+    printf("  %s: %llu calls, avg %llu ns, p50 < %llu ns, p99 < %llu ns, max %llu ns\n", label,
+           (unsigned long long)histogram->count, (unsigned long long)(histogram->totalNanoseconds / histogram->count),
+           (unsigned long long)goofy_histogramPercentile(histogram, 50.0), (unsigned long long)goofy_histogramPercentile(histogram, 99.0),
+           (unsigned long long)histogram->maxNanoseconds);
+}
+void goofy_printStats(void) {
+    printf("[GOOFYLIB3] Stats after %llu frames\n", (unsigned long long)goofy_stats.frames);
+    goofy_printCounters("last frame", &goofy_stats.lastFrame);
+    goofy_printCounters("total", &goofy_stats.total);
+    goofy_printHistogram("goofy_renderMesh", &goofy_stats.renderMesh);
+    goofy_printHistogram("goofy_drawAllMeshes* + goofy_drawRenderQueue", &goofy_stats.drawAllMeshes);
+    goofy_printHistogram("frame time", &goofy_stats.frameTime);
+}
+static void goofy_writeCountersJson(FILE* file, const GOOFY_COUNTERS* counters) {
+    fprintf(file, "{\"meshesSubmitted\":%llu,\"meshesDropped\":%llu,\"verticesUploaded\":%llu,\"indicesUploaded\":%llu,\"bytesUploaded\":%llu,"
+                  "\"drawCalls\":%llu,\"multiDrawCommands\":%llu,\"stateBinds\":%llu,\"textureUploads\":%llu,"
+                  "\"mipGenerations\":%llu,\"arrayGrowths\":%llu}",
+            (unsigned long long)counters->meshesSubmitted, (unsigned long long)counters->meshesDropped, (unsigned long long)counters->verticesUploaded,
+            (unsigned long long)counters->indicesUploaded, (unsigned long long)counters->bytesUploaded,
+            (unsigned long long)counters->drawCalls, (unsigned long long)counters->multiDrawCommands,
+            (unsigned long long)counters->stateBinds, (unsigned long long)counters->textureUploads,
+            (unsigned long long)counters->mipGenerations, (unsigned long long)counters->arrayGrowths);
+}
+static void goofy_writeHistogramJson(FILE* file, const GOOFY_HISTOGRAM* histogram) {
+    fprintf(file, "{\"count\":%llu,\"totalNs\":%llu,\"maxNs\":%llu,\"p50Ns\":%llu,\"p90Ns\":%llu,\"p99Ns\":%llu,\"buckets\":[",
+            (unsigned long long)histogram->count, (unsigned long long)histogram->totalNanoseconds,
+            (unsigned long long)histogram->maxNanoseconds, (unsigned long long)goofy_histogramPercentile(histogram, 50.0),
+            (unsigned long long)goofy_histogramPercentile(histogram, 90.0), (unsigned long long)goofy_histogramPercentile(histogram, 99.0));
+    for (unsigned int i = 0; i < GOOFY_HISTOGRAM_BUCKETS; ++i) {
+        fprintf(file, "%s%llu", i ? "," : "", (unsigned long long)histogram->buckets[i]);
+    }
+    fprintf(file, "]}");
+}
+char goofy_writeStatsJson(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "[GOOFYLIB3] Failed to open stats file: %s\n", path);
+        return 0;
+    }
+    fprintf(file, "{\"frames\":%llu,\n\"lastFrame\":", (unsigned long long)goofy_stats.frames);
+    goofy_writeCountersJson(file, &goofy_stats.lastFrame);
+    fprintf(file, ",\n\"total\":");
+    goofy_writeCountersJson(file, &goofy_stats.total);
+    fprintf(file, ",\n\"renderMesh\":");
+    goofy_writeHistogramJson(file, &goofy_stats.renderMesh);
+    fprintf(file, ",\n\"drawAllMeshes\":");
+    goofy_writeHistogramJson(file, &goofy_stats.drawAllMeshes);
+    fprintf(file, ",\n\"frameTime\":");
+    goofy_writeHistogramJson(file, &goofy_stats.frameTime);
+    fprintf(file, "}\n");
+    char ok = ferror(file) == 0;
+    if (fclose(file) != 0) ok = 0;
+    if (!ok) fprintf(stderr, "[GOOFYLIB3] Failed to write stats file: %s\n", path);
+    return ok;
+}
+void goofy_resetStats(void) {
+    memset(&goofy_stats, 0, sizeof(goofy_stats));
+    goofy_lastStatsFrame = 0;
+}
+
+// TRACING functions
+#ifdef GOOFY_TRACE
+uint64_t goofy_traceNow(void) {
+    return goofy_clockNow();
+}
+void goofy_traceZone(const char* name, uint64_t start, uint64_t end) {
+    GOOFY_TRACE_RING* ring = goofy_threadRing;
+    unsigned int generation = atomic_load_explicit(&goofy_traceGeneration, memory_order_relaxed);
+    if (!ring || goofy_threadRingGeneration != generation) {
+        ring = (GOOFY_TRACE_RING*)calloc(1, sizeof(GOOFY_TRACE_RING));
+        if (!ring) return;
+        ring->thread = atomic_fetch_add(&goofy_traceThreads, 1) + 1;
+        ring->next = atomic_load(&goofy_traceRings);
+        while (!atomic_compare_exchange_weak(&goofy_traceRings, &ring->next, ring)) {}
+        goofy_threadRing = ring;
+        goofy_threadRingGeneration = generation;
+    }
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    GOOFY_TRACE_EVENT* event = &ring->events[head & (GOOFY_TRACE_RING_SIZE - 1)];
+    event->name = name;
+    event->start = start;
+    event->end = end;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+// names are usually function names but zones from users could have anything in them
+static void goofy_writeTraceString(FILE* file, const char* text) {
+    fputc('"', file);
+    for (; *text; ++text) {
+        if (*text == '"' || *text == '\\') fputc('\\', file);
+        if ((unsigned char)*text >= 0x20) fputc(*text, file);
+    }
+    fputc('"', file);
+}
+char goofy_writeTrace(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        fprintf(stderr, "[GOOFYLIB3] Failed to open trace file: %s\n", path);
+        return 0;
+    }
+    size_t written = 0;
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    for (GOOFY_TRACE_RING* ring = atomic_load(&goofy_traceRings); ring; ring = ring->next) {
+        size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        size_t first = head > GOOFY_TRACE_RING_SIZE ? head - GOOFY_TRACE_RING_SIZE : 0;
+        if (ring->cleared > first) first = ring->cleared;
+        fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}",
+                written++ ? "," : "", ring->thread, ring->thread);
+        for (size_t i = first; i < head; ++i) {
+            const GOOFY_TRACE_EVENT* event = &ring->events[i & (GOOFY_TRACE_RING_SIZE - 1)];
+            fprintf(file, ",\n{\"name\":");
+            goofy_writeTraceString(file, event->name);
+            fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", ring->thread,
+                    (double)event->start / 1000.0, (double)(event->end - event->start) / 1000.0);
+            written++;
+        }
+    }
+    fprintf(file, "\n]}\n");
+    char ok = ferror(file) == 0;
+    if (fclose(file) != 0) ok = 0;
+    if (!ok) {
+        fprintf(stderr, "[GOOFYLIB3] Failed to write trace file: %s\n", path);
+        return 0;
+    }
+    printf("[GOOFYLIB3] Wrote trace: %s\n", path);
+    return 1;
+}
+void goofy_clearTrace(void) {
+    for (GOOFY_TRACE_RING* ring = atomic_load(&goofy_traceRings); ring; ring = ring->next) {
+        ring->cleared = atomic_load_explicit(&ring->head, memory_order_acquire);
+    }
+}
+#else
+char goofy_writeTrace(const char* path) {
+    (void)path;
+    fprintf(stderr, "[GOOFYLIB3] Tracing is off, build with GOOFY_TRACE defined\n");
+    return 0;
+}
+void goofy_clearTrace(void) {}
+#endif
+
+// CULLING functions
+const GOOFY_BOUNDS* goofy_meshBounds(GOOFY_MESH* mesh) {
+    if (mesh->boundsValid) return &mesh->bounds;
+    GOOFY_BOUNDS* bounds = &mesh->bounds;
+    memset(bounds, 0, sizeof(GOOFY_BOUNDS));
+    for (size_t i = 0; i < mesh->vertexCount; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            float value = mesh->vertices[i].position[c];
+            if (i == 0 || value < bounds->min[c]) bounds->min[c] = value;
+            if (i == 0 || value > bounds->max[c]) bounds->max[c] = value;
+        }
+    }
+    // sphere around the middle of the box, loose but cheap to test
+    float radius = 0.0f;
+    for (int c = 0; c < 3; ++c) {
+        bounds->sphere[c] = (bounds->min[c] + bounds->max[c]) * 0.5f;
+    }
+    for (size_t i = 0; i < mesh->vertexCount; ++i) {
+        const float* p = mesh->vertices[i].position;
+        float dx = p[0] - bounds->sphere[0], dy = p[1] - bounds->sphere[1], dz = p[2] - bounds->sphere[2];
+        float distance = dx * dx + dy * dy + dz * dz;
+        if (distance > radius) radius = distance;
+    }
+    bounds->sphere[3] = sqrtf(radius);
+    mesh->boundsValid = 1;
+    return bounds;
+}
+GOOFY_CULL_LIST goofy_initCullList(size_t capacity) {
+    GOOFY_CULL_LIST list;
+    memset(&list, 0, sizeof(list));
+    if (capacity == 0) capacity = 64;
+    list.centerX = (float*)malloc(sizeof(float) * capacity);
+    list.centerY = (float*)malloc(sizeof(float) * capacity);
+    list.centerZ = (float*)malloc(sizeof(float) * capacity);
+    list.radius = (float*)malloc(sizeof(float) * capacity);
+    if (!list.centerX || !list.centerY || !list.centerZ || !list.radius) {
+        fprintf(stderr, "[GOOFYLIB3] Failed to allocate cull list\n");
+        goofy_freeCullList(&list);
+        return list;
+    }
+    list.capacity = capacity;
+    return list;
+}
+size_t goofy_addCullSphere(GOOFY_CULL_LIST* list, const float* sphere) {
+    if (list->count >= list->capacity) {
+        size_t newCapacity = list->capacity ? list->capacity * 2 : 64;
+        float* centerX = realloc(list->centerX, sizeof(float) * newCapacity);
+        if (centerX) list->centerX = centerX;
+        float* centerY = realloc(list->centerY, sizeof(float) * newCapacity);
+        if (centerY) list->centerY = centerY;
+        float* centerZ = realloc(list->centerZ, sizeof(float) * newCapacity);
+        if (centerZ) list->centerZ = centerZ;
+        float* radius = realloc(list->radius, sizeof(float) * newCapacity);
+        if (radius) list->radius = radius;
+        if (!centerX || !centerY || !centerZ || !radius) {
+            fprintf(stderr, "[GOOFYLIB3] Cull list is full, sphere skipped\n");
+            return (size_t)-1;
+        }
+        list->capacity = newCapacity;
+        goofy_countGrowths(NULL, 4);
+    }
+    size_t index = list->count++;
+    list->centerX[index] = sphere[0];
+    list->centerY[index] = sphere[1];
+    list->centerZ[index] = sphere[2];
+    list->radius[index] = sphere[3];
+    return index;
+}
+static char goofy_sphereVisible(const float* planes, float x, float y, float z, float radius) {
+    for (int p = 0; p < 6; ++p) {
+        const float* plane = planes + p * 4;
+        if (plane[0] * x + plane[1] * y + plane[2] * z + plane[3] < -radius) return 0;
     }
+    return 1;
+}
+size_t goofy_cullSpheres(const GOOFY_CULL_LIST* list, const float* viewProjection, unsigned int* visible) {
+    float planes[24];
+    goofy_frustumPlanes(viewProjection, planes);
+    size_t visibleCount = 0;
+    size_t i = 0;
 
-    printf("\n");
+#if GOOFY_CULL_WIDTH == 8
+    for (; i + 8 <= list->count; i += 8) {
+        __m256 x = _mm256_loadu_ps(list->centerX + i);
+        __m256 y = _mm256_loadu_ps(list->centerY + i);
+        __m256 z = _mm256_loadu_ps(list->centerZ + i);
+        __m256 negRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(list->radius + i));
+        __m256 outside = _mm256_setzero_ps();
+        for (int p = 0; p < 6; ++p) {
+            const float* plane = planes + p * 4;
+            __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(plane[0])), _mm256_mul_ps(y, _mm256_set1_ps(plane[1]))),
+                                            _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(plane[2])), _mm256_set1_ps(plane[3])));
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(distance, negRadius, _CMP_LT_OQ));
+        }
+        int mask = ~_mm256_movemask_ps(outside) & 0xFF;
+        for (int bit = 0; bit < 8; ++bit) {
+            if (mask & (1 << bit)) visible[visibleCount++] = (unsigned int)(i + bit);
+        }
+    }
+#elif GOOFY_CULL_WIDTH == 4
+    for (; i + 4 <= list->count; i += 4) {
+        __m128 x = _mm_loadu_ps(list->centerX + i);
+        __m128 y = _mm_loadu_ps(list->centerY + i);
+        __m128 z = _mm_loadu_ps(list->centerZ + i);
+        __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(list->radius + i));
+        __m128 outside = _mm_setzero_ps();
+        for (int p = 0; p < 6; ++p) {
+            const float* plane = planes + p * 4;
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane[0])), _mm_mul_ps(y, _mm_set1_ps(plane[1]))),
+                                         _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(plane[2])), _mm_set1_ps(plane[3])));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negRadius));
+        }
+        int mask = ~_mm_movemask_ps(outside) & 0xF;
+        for (int bit = 0; bit < 4; ++bit) {
+            if (mask & (1 << bit)) visible[visibleCount++] = (unsigned int)(i + bit);
+        }
+    }
+#endif
+    // what doesnt fill a whole vector
+    for (; i < list->count; ++i) {
+        if (goofy_sphereVisible(planes, list->centerX[i], list->centerY[i], list->centerZ[i], list->radius[i])) {
+            visible[visibleCount++] = (unsigned int)i;
+        }
+    }
+    return visibleCount;
 }
-void error_callback(int error, const char* description){
-    fprintf(stderr, "[GOOFYLIB3] ERROR : %s\n", description);
+void goofy_clearCullList(GOOFY_CULL_LIST* list) {
+    list->count = 0;
 }
-void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
-    glfwMakeContextCurrent(window); // 👈 Ensure the correct context
-    glViewport(0, 0, width, height);
+void goofy_freeCullList(GOOFY_CULL_LIST* list) {
+    free(list->centerX);
+    free(list->centerY);
+    free(list->centerZ);
+    free(list->radius);
+    list->centerX = NULL;
+    list->centerY = NULL;
+    list->centerZ = NULL;
+    list->radius = NULL;
+    list->count = 0;
+    list->capacity = 0;
 }
 
+// FILE-LOADING functions
+// what goofy_objMesh has parsed so far, the v/vt/vn lists are flat (3, 2 and 3 floats per entry).
+// goofy_objMeshParallel has one per chunk, the bases are how many v/vt/vn came before the chunk
+typedef struct {
+    float* positions;
+    size_t positionCount, positionCapacity, positionBase;
+    float* texCoords;
+    size_t texCoordCount, texCoordCapacity, texCoordBase;
+    float* normals;
+    size_t normalCount, normalCapacity, normalBase;
+    size_t vertexCount; // one per different v/vt/vn corner
+    unsigned int* keys; // the v, vt + 1, vn + 1 (0 = not given) of every vertex
+    size_t keyCapacity;
+    unsigned int* table; // open addressing, vertex + 1 (0 = empty), power of 2 size
+    size_t tableCapacity;
+    unsigned int* indices;
+    size_t indexCount, indexCapacity;
+    unsigned int* corners; // keys of the face being parsed
+    size_t cornerCapacity;
+    size_t faces;
+    size_t badLines;
+    size_t line;
+    char outOfMemory;
+} GOOFY_OBJ_STATE;
 
-// MAIN MODULE
-GLFWwindow* goofy_initWindow(const char* windowName, int width, int height, int major_version, int minor_version) {
-    glfwSetErrorCallback(error_callback);
-    printf("[GOOFYLIB3] Initializing window %s\n",windowName); 
-    if (!glfwInit()) {
-        printf("[GOOFYLIB3] Failed to initialize GLFW for window %s\n",windowName);
-        return NULL; 
-    } else {
-        printf("[GOOFYLIB3] Succesfully initialized GLFW for window %s\n",windowName); 
-    }
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, major_version);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, minor_version);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+// doubles the capacity until count more elements fit
+static char goofy_reserveObjArray(void** array, size_t* capacity, size_t count, size_t needed, size_t elementSize) {
+    if (count + needed <= *capacity) return 1;
+    size_t newCapacity = *capacity ? *capacity : 4096;
+    while (newCapacity < count + needed) newCapacity *= 2;
+    void* grown = realloc(*array, newCapacity * elementSize);
+    if (!grown) return 0;
+    *array = grown;
+    *capacity = newCapacity;
+    return 1;
+}
+static const char* goofy_skipBlanks(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    return p;
+}
+// strtof is most of the time of a big OBJ, this handles what OBJ exporters write ([-]digits[.digits][e[-]digits]).
+// Returns NULL if there is no number. Up to 19 significant digits are kept, more than a float can hold anyway.
+static const char* goofy_parseFloat(const char* p, const char* end, float* out) {
+    static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    p = goofy_skipBlanks(p, end);
+    char negative = 0;
+    if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
 
-    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_FALSE);  
-    
-    // WINDOW MAKE
-    GLFWwindow* window = glfwCreateWindow(width, height, windowName, NULL, NULL);
-    if (!window) {
-        printf("[GOOFYLIB3] Failed to create a window for window %s\n",windowName);
-        glfwTerminate();
-        return NULL;
-    } else {
-        printf("[GOOFYLIB3] Succesfully initialized a window for window %s\n",windowName); 
+    uint64_t mantissa = 0;
+    int exponent = 0, significant = 0, digits = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p, ++digits) {
+        if (significant < 19) {
+            mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+            if (mantissa) significant++;
+        } else {
+            exponent++;
+        }
     }
-    glfwMakeContextCurrent(window);
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-        printf("[GOOFYLIB3] Failed to initialize GLAD for window %s\n",windowName);
-        glfwDestroyWindow(window);  
-        glfwTerminate();
-        return NULL;  
-    } else {
-        printf("[GOOFYLIB3] Succesfully initialized GLAD for window %s\n",windowName); 
+    if (p < end && *p == '.') {
+        for (++p; p < end && *p >= '0' && *p <= '9'; ++p, ++digits) {
+            if (significant < 19) {
+                mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+                if (mantissa) significant++;
+                exponent--;
+            }
+        }
+    }
+    if (digits == 0) return NULL;
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char* e = p + 1;
+        char negativeExponent = 0;
+        if (e < end && (*e == '-' || *e == '+')) negativeExponent = *e++ == '-';
+        if (e < end && *e >= '0' && *e <= '9') {
+            int value = 0;
+            for (; e < end && *e >= '0' && *e <= '9'; ++e) {
+                if (value < 10000) value = value * 10 + (*e - '0');
+            }
+            exponent += negativeExponent ? -value : value;
+            p = e;
+        }
     }
 
-    glViewport(0, 0, width, height);
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-    GLint flags;
-    glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
-    if (flags & GL_CONTEXT_FLAG_DEBUG_BIT)
-    {
-        glEnable(GL_DEBUG_OUTPUT);
-        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS); 
-        glDebugMessageCallback(glDebugOutput, NULL);
-        glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, NULL, GL_TRUE);
-    } 
-    printf("[GOOFYLIB3] Succesfully made window %s\n",windowName); 
-    return window;
+    double value = (double)mantissa;
+    if (mantissa != 0 && exponent != 0) {
+        if (exponent > 0 && exponent <= 22) value *= powers[exponent];
+        else if (exponent < 0 && exponent >= -22) value /= powers[-exponent];
+        else value *= pow(10.0, exponent);
+    }
+    *out = (float)(negative ? -value : value);
+    return p;
 }
-GLuint goofy_initShaders(const char* vertexPath,const char* fragmentPath) {
-    GLuint shaderProgram = create_shader_program(vertexPath,fragmentPath);
-    if (shaderProgram == 0) {
-        printf("Failed to create shader program\n");
-        exit(1);
+static const char* goofy_parseInt(const char* p, const char* end, long* out) {
+    char negative = 0;
+    if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+    if (p >= end || *p < '0' || *p > '9') return NULL;
+    long value = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+        if (value < (LONG_MAX - 9) / 10) value = value * 10 + (*p - '0');
     }
-    return shaderProgram;
+    *out = negative ? -value : value;
+    return p;
 }
-GOOFY_BUFFER goofy_initBuffer(GLuint maxVertices, GLuint maxIndices, size_t maxMeshes) {
-    GOOFY_BUFFER buffer;
-    buffer.MAX_MESHES = maxMeshes;
-    buffer.meshCount = 0;
-    buffer.currentVerticeOffset = 0;
-    buffer.currentIndiceOffset = 0;
-
-    // alloc arrays
-    buffer.vertexOffsets = (size_t*)malloc(sizeof(size_t) * maxMeshes);
-    buffer.indexOffsets = (size_t*)malloc(sizeof(size_t) * maxMeshes);
-    buffer.vertexCounts = (size_t*)malloc(sizeof(size_t) * maxMeshes);
-    buffer.indexCounts = (size_t*)malloc(sizeof(size_t) * maxMeshes);
-    printf("[GOOFYLIB3] Succesfully allocated buffers\n");
-    if (!buffer.vertexOffsets || !buffer.indexOffsets || !buffer.vertexCounts || !buffer.indexCounts) {
-        printf("[GOOFYLIB3] Failed to allocate memory for mesh data arrays\n");
+// parses count floats into dst, missing ones after the first become 0 (vt with only u).
+// Returns 0 if fewer than required were there, dst is still filled up with 0 so a bad line never leaves garbage behind
+static char goofy_parseFloats(const char* p, const char* end, float* dst, int count, int required) {
+    for (int i = 0; i < count; ++i) {
+        const char* next = goofy_parseFloat(p, end, &dst[i]);
+        if (!next) {
+            char enough = i >= required;
+            for (; i < count; ++i) dst[i] = 0.0f;
+            return enough;
+        }
+        p = next;
     }
-
-    glGenVertexArrays(1, &buffer.VAO);
-    glBindVertexArray(buffer.VAO);
-    if (buffer.VAO == 0) {
-        printf("[GOOFYLIB3] Failed to generate VAO\n");
-    } else {
-        printf("[GOOFYLIB3] Successfully initialized VAO\n");
+    return 1;
+}
+// 1 based, negative counts back from the end, 0 = not given. Returns (size_t)-1 if it points nowhere
+static size_t goofy_objIndex(long index, size_t count) {
+    if (index > 0 && (size_t)index <= count) return (size_t)index - 1;
+    if (index < 0 && (size_t)(-index) <= count) return count - (size_t)(-index);
+    return (size_t)-1;
+}
+static void goofy_badObjLine(GOOFY_OBJ_STATE* state, const char* what) {
+    if (state->badLines++ < 10) fprintf(stderr, "[GOOFYLIB3] Warning: %s on line %zu\n", what, state->line);
+}
+static size_t goofy_hashCorner(const unsigned int* key) {
+    uint64_t h = (uint64_t)key[0] * 0x9E3779B97F4A7C15ull;
+    h ^= (uint64_t)key[1] * 0xC2B2AE3D27D4EB4Full + (h >> 29);
+    h ^= (uint64_t)key[2] * 0x165667B19E3779F9ull + (h >> 32);
+    h ^= h >> 33;
+    return (size_t)h;
+}
+// doubles the welding table and puts every vertex back in
+static char goofy_growObjTable(GOOFY_OBJ_STATE* state) {
+    size_t capacity = state->tableCapacity ? state->tableCapacity * 2 : 8192;
+    unsigned int* table = (unsigned int*)calloc(capacity, sizeof(unsigned int));
+    if (!table) return 0;
+    for (size_t v = 0; v < state->vertexCount; ++v) {
+        size_t slot = goofy_hashCorner(state->keys + v * 3) & (capacity - 1);
+        while (table[slot]) slot = (slot + 1) & (capacity - 1);
+        table[slot] = (unsigned int)(v + 1);
     }
-
-    glGenBuffers(1, &buffer.VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, buffer.VBO);
-    if (buffer.VBO == 0) {
-        printf("[GOOFYLIB3] Failed to generate VBO\n");
-    } else {
-        printf("[GOOFYLIB3] Allocating VBO with size: %zu\n", maxVertices * sizeof(GOOFY_VERTICE));
-        glBufferData(GL_ARRAY_BUFFER, maxVertices * sizeof(GOOFY_VERTICE), NULL, GL_DYNAMIC_DRAW);
-        printf("[GOOFYLIB3] Successfully initialized VBO\n");
+    free(state->table);
+    state->table = table;
+    state->tableCapacity = capacity;
+    return 1;
+}
+// returns the vertex of a corner, made the first time the v/vt/vn combination shows up. UINT_MAX if out of memory
+static unsigned int goofy_weldObjCorner(GOOFY_OBJ_STATE* state, const unsigned int* key) {
+    if ((state->vertexCount + 1) * 2 > state->tableCapacity && !goofy_growObjTable(state)) return UINT_MAX;
+    size_t mask = state->tableCapacity - 1;
+    size_t slot = goofy_hashCorner(key) & mask;
+    for (; state->table[slot]; slot = (slot + 1) & mask) {
+        const unsigned int* other = state->keys + (size_t)(state->table[slot] - 1) * 3;
+        if (other[0] == key[0] && other[1] == key[1] && other[2] == key[2]) return state->table[slot] - 1;
     }
+    if (state->vertexCount >= UINT_MAX - 1) return UINT_MAX; // indices are 32 bit
+    if (!goofy_reserveObjArray((void**)&state->keys, &state->keyCapacity, state->vertexCount * 3, 3, sizeof(unsigned int))) return UINT_MAX;
 
-    glGenBuffers(1, &buffer.EBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer.EBO);
-    if (buffer.EBO == 0) {
-        printf("[GOOFYLIB3] Failed to generate EBO.\n");
-    } else {
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * maxIndices, NULL, GL_DYNAMIC_DRAW);
-        printf("[GOOFYLIB3] Successfully initialized EBO\n");
+    unsigned int vertex = (unsigned int)state->vertexCount++;
+    memcpy(state->keys + (size_t)vertex * 3, key, sizeof(unsigned int) * 3);
+    state->table[slot] = vertex + 1;
+    return vertex;
+}
+// the vertices get built from the keys once the whole file is parsed, a face can point to v/vt/vn of a later chunk
+static void goofy_buildObjVertex(GOOFY_VERTICE* vertex, const unsigned int* key, const float* positions, const float* texCoords, const float* normals) {
+    memcpy(vertex->position, positions + (size_t)key[0] * 3, sizeof(vertex->position));
+    if (key[1]) memcpy(vertex->texCoords, texCoords + (size_t)(key[1] - 1) * 2, sizeof(vertex->texCoords));
+    else vertex->texCoords[0] = vertex->texCoords[1] = 0.0f;
+    if (key[2]) memcpy(vertex->normals, normals + (size_t)(key[2] - 1) * 3, sizeof(vertex->normals));
+    else vertex->normals[0] = vertex->normals[1] = vertex->normals[2] = 0.0f;
+    vertex->colors[0] = vertex->colors[1] = vertex->colors[2] = 1.0f;
+    vertex->texIndex = 0;
+    vertex->is3d = 1;
+}
+// a face corner is v, v/vt, v//vn or v/vt/vn, polygons get split into a triangle fan.
+// All corners are checked first so a bad face doesnt leave vertices behind.
+static void goofy_parseObjFace(GOOFY_OBJ_STATE* state, const char* p, const char* end) {
+    size_t corners = 0;
+    while ((p = goofy_skipBlanks(p, end)) < end) {
+        long v = 0, t = 0, n = 0;
+        p = goofy_parseInt(p, end, &v);
+        if (p && p < end && *p == '/') {
+            ++p;
+            if (p < end && *p != '/') p = goofy_parseInt(p, end, &t);
+            if (p && p < end && *p == '/') p = goofy_parseInt(p + 1, end, &n);
+        }
+        if (!p || (p < end && *p != ' ' && *p != '\t')) {
+            goofy_badObjLine(state, "Malformed face");
+            return;
+        }
+        size_t vi = goofy_objIndex(v, state->positionBase + state->positionCount);
+        size_t ti = t ? goofy_objIndex(t, state->texCoordBase + state->texCoordCount) : 0;
+        size_t ni = n ? goofy_objIndex(n, state->normalBase + state->normalCount) : 0;
+        if (vi == (size_t)-1 || ti == (size_t)-1 || ni == (size_t)-1) {
+            goofy_badObjLine(state, "Face index out of bounds");
+            return;
+        }
+        if (!goofy_reserveObjArray((void**)&state->corners, &state->cornerCapacity, corners * 3, 3, sizeof(unsigned int))) {
+            state->outOfMemory = 1;
+            return;
+        }
+        unsigned int* key = state->corners + corners * 3;
+        key[0] = (unsigned int)vi;
+        key[1] = t ? (unsigned int)ti + 1 : 0;
+        key[2] = n ? (unsigned int)ni + 1 : 0;
+        corners++;
+    }
+    if (corners < 3) {
+        goofy_badObjLine(state, "Face with less than 3 corners");
+        return;
+    }
+    if (!goofy_reserveObjArray((void**)&state->indices, &state->indexCapacity, state->indexCount, (corners - 2) * 3, sizeof(unsigned int))) {
+        state->outOfMemory = 1;
+        return;
     }
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, VERTEX_MEMORY_SIZE, (void*)offsetof(GOOFY_VERTICE, position));
-    glEnableVertexAttribArray(0);
+    unsigned int first = 0, previous = 0;
+    for (size_t i = 0; i < corners; ++i) {
+        unsigned int vertex = goofy_weldObjCorner(state, state->corners + i * 3);
+        if (vertex == UINT_MAX) {
+            state->outOfMemory = 1;
+            return;
+        }
+        if (i == 0) first = vertex;
+        if (i >= 2) {
+            state->indices[state->indexCount++] = first;
+            state->indices[state->indexCount++] = previous;
+            state->indices[state->indexCount++] = vertex;
+        }
+        previous = vertex;
+    }
+    state->faces++;
+}
+// what kind of line it is: 'v', 't' (vt), 'n' (vn), 'f' or 0 for everything else (comments, o, g, usemtl ...).
+// *line gets moved past the keyword. goofy_objMeshParallel counts with this too so its counts always match the parse
+static char goofy_objLineType(const char** line, const char* end) {
+    const char* p = goofy_skipBlanks(*line, end);
+    if (end - p < 2) return 0;
+    if (p[1] == ' ' || p[1] == '\t') {
+        *line = p + 2;
+        return (p[0] == 'v' || p[0] == 'f') ? p[0] : 0;
+    }
+    if (p[0] == 'v' && (p[1] == 't' || p[1] == 'n') && end - p > 2 && (p[2] == ' ' || p[2] == '\t')) {
+        *line = p + 3;
+        return p[1];
+    }
+    return 0;
+}
+static void goofy_parseObjLine(GOOFY_OBJ_STATE* state, const char* p, const char* end) {
+    state->line++;
+    if (end > p && end[-1] == '\r') end--;
+    char type = goofy_objLineType(&p, end);
+    if (type == 'f') {
+        goofy_parseObjFace(state, p, end);
+    } else if (type == 'v') {
+        if (!goofy_reserveObjArray((void**)&state->positions, &state->positionCapacity, state->positionCount * 3, 3, sizeof(float))) {
+            state->outOfMemory = 1;
+            return;
+        }
+        // a bad line still takes its index so the faces after it point to the right vertices
+        float* position = state->positions + state->positionCount++ * 3;
+        if (!goofy_parseFloats(p, end, position, 3, 3)) goofy_badObjLine(state, "Malformed vertex");
+    } else if (type == 't') {
+        if (!goofy_reserveObjArray((void**)&state->texCoords, &state->texCoordCapacity, state->texCoordCount * 2, 2, sizeof(float))) {
+            state->outOfMemory = 1;
+            return;
+        }
+        float* texCoord = state->texCoords + state->texCoordCount++ * 2;
+        if (!goofy_parseFloats(p, end, texCoord, 2, 1)) goofy_badObjLine(state, "Malformed texture coord");
+    } else if (type == 'n') {
+        if (!goofy_reserveObjArray((void**)&state->normals, &state->normalCapacity, state->normalCount * 3, 3, sizeof(float))) {
+            state->outOfMemory = 1;
+            return;
+        }
+        float* normal = state->normals + state->normalCount++ * 3;
+        if (!goofy_parseFloats(p, end, normal, 3, 3)) goofy_badObjLine(state, "Malformed normal");
+    }
+}
+GOOFY_MESH goofy_objMesh(const char* filepath) {
+    GOOFY_ZONE_BEGIN("goofy_objMesh");
+    GOOFY_MESH result = {0};
+    FILE* file = fopen(filepath, "rb");
+    if (!file) {
+        fprintf(stderr, "[GOOFYLIB3] Failed to open OBJ file: %s\n", filepath);
+        GOOFY_ZONE_END();
+        return result;
+    }
 
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, VERTEX_MEMORY_SIZE, (void*)offsetof(GOOFY_VERTICE, colors));
-    glEnableVertexAttribArray(1);
+    printf("[GOOFYLIB3] Parsing OBJ file: %s\n", filepath);
+    GOOFY_OBJ_STATE state;
+    memset(&state, 0, sizeof(state));
+    size_t blockSize = GOOFY_OBJ_BLOCK;
+    char* block = (char*)malloc(blockSize);
+    size_t filled = 0;
+    char noBlock = block == NULL;
+    char done = noBlock;
+    // one pass over the file, lines are parsed straight out of the block, only the unfinished last line gets moved to the front
+    while (!done && !state.outOfMemory) {
+        size_t wanted = blockSize - filled;
+        size_t got = fread(block + filled, 1, wanted, file);
+        filled += got;
+        done = got < wanted;
 
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, VERTEX_MEMORY_SIZE, (void*)offsetof(GOOFY_VERTICE, normals));
-    glEnableVertexAttribArray(2);
+        const char* cursor = block;
+        const char* limit = block + filled;
+        const char* newline;
+        while ((newline = (const char*)memchr(cursor, '\n', (size_t)(limit - cursor))) != NULL) {
+            goofy_parseObjLine(&state, cursor, newline);
+            cursor = newline + 1;
+        }
+        size_t rest = (size_t)(limit - cursor);
+        if (done) {
+            if (rest > 0) goofy_parseObjLine(&state, cursor, limit);
+            break;
+        }
+        if (rest == blockSize) { // one line is longer than the whole block
+            char* bigger = (char*)realloc(block, blockSize * 2);
+            if (!bigger) {
+                state.outOfMemory = 1;
+                break;
+            }
+            block = bigger;
+            blockSize *= 2;
+        } else {
+            memmove(block, cursor, rest);
+        }
+        filled = rest;
+    }
+    char readError = ferror(file) != 0;
+    fclose(file);
+    free(block);
+    free(state.table);
+    free(state.corners);
 
-    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, VERTEX_MEMORY_SIZE, (void*)offsetof(GOOFY_VERTICE, texCoords));
-    glEnableVertexAttribArray(3);
+    GOOFY_VERTICE* vertices = NULL;
+    if (!noBlock && !state.outOfMemory && !readError && state.vertexCount) {
+        vertices = (GOOFY_VERTICE*)malloc(sizeof(GOOFY_VERTICE) * state.vertexCount);
+        if (!vertices) state.outOfMemory = 1;
+        for (size_t v = 0; vertices && v < state.vertexCount; ++v) {
+            goofy_buildObjVertex(&vertices[v], state.keys + v * 3, state.positions, state.texCoords, state.normals);
+        }
+    }
+    free(state.positions);
+    free(state.texCoords);
+    free(state.normals);
+    free(state.keys);
 
-    glVertexAttribIPointer(4, 1, GL_INT, VERTEX_MEMORY_SIZE, (void*)offsetof(GOOFY_VERTICE, texIndex));
-    glEnableVertexAttribArray(4);
+    if (noBlock || state.outOfMemory || readError) {
+        fprintf(stderr, readError ? "[GOOFYLIB3] Failed to read OBJ file: %s\n" : "[GOOFYLIB3] Memory allocation failed\n", filepath);
+        free(vertices);
+        free(state.indices);
+        GOOFY_ZONE_END();
+        return result;
+    }
+    if (state.badLines > 10) fprintf(stderr, "[GOOFYLIB3] Warning: %zu bad lines in total\n", state.badLines);
+    printf("[GOOFYLIB3] Parsed %zu vertices, %zu texture coords, %zu normals, %zu faces\n",
+           state.positionCount, state.texCoordCount, state.normalCount, state.faces);
 
-    glVertexAttribIPointer(5, 1, GL_UNSIGNED_INT, VERTEX_MEMORY_SIZE, (void*)offsetof(GOOFY_VERTICE, is3d));
-    glEnableVertexAttribArray(5);
+    // the index array was grown by doubling, give back what isnt used
+    unsigned int* indices = state.indexCount ? (unsigned int*)realloc(state.indices, sizeof(unsigned int) * state.indexCount) : NULL;
+    result.vertices = vertices;
+    result.indices = indices ? indices : state.indices;
+    result.vertexCount = state.vertexCount;
+    result.indexCount = state.indexCount;
 
-    printf("[GOOFYLIB3] Initialized all vertex attributes for VAO\n");
+    printf("[GOOFYLIB3] Final mesh: %zu vertices, %zu indices\n", result.vertexCount, result.indexCount);
+    goofy_initMeshState(&result);
+    GOOFY_ZONE_END();
+    return result;
+}
 
-    glBindVertexArray(0);
+#ifdef GOOFY_PARALLEL_OBJ
+#define GOOFY_OBJ_MAX_THREADS 64
 
-    return buffer;
+typedef struct {
+    void (*work)(void* context, size_t item);
+    void* context;
+    size_t items;
+    atomic_size_t next;
+} GOOFY_PARALLEL_FOR;
+static void* goofy_parallelWorker(void* argument) {
+    GOOFY_PARALLEL_FOR* loop = (GOOFY_PARALLEL_FOR*)argument;
+    for (size_t item; (item = atomic_fetch_add(&loop->next, 1)) < loop->items;) loop->work(loop->context, item);
+    return NULL;
 }
-void goofy_renderMesh(GOOFY_BUFFER* buffer, GOOFY_MESH* mesh) {
-    if (buffer->meshCount >= buffer->MAX_MESHES) {
-        fprintf(stderr, "Exceeded max mesh count!\n");
-        return;
+// runs work(context, 0 ... items - 1) on up to threadCount threads (this one is one of them) and waits for all of them.
+// If a thread cant be started the others just take its items
+static void goofy_parallelFor(unsigned int threadCount, size_t items, void (*work)(void*, size_t), void* context) {
+    GOOFY_PARALLEL_FOR loop;
+    loop.work = work;
+    loop.context = context;
+    loop.items = items;
+    atomic_init(&loop.next, 0);
+    pthread_t threads[GOOFY_OBJ_MAX_THREADS];
+    unsigned int started = 0;
+    while (started + 1 < threadCount && started + 1 < items) {
+        if (pthread_create(&threads[started], NULL, goofy_parallelWorker, &loop) != 0) break;
+        started++;
     }
+    goofy_parallelWorker(&loop);
+    for (unsigned int i = 0; i < started; ++i) pthread_join(threads[i], NULL);
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, buffer->VBO);
-    glBufferSubData(GL_ARRAY_BUFFER, buffer->currentVerticeOffset * sizeof(GOOFY_VERTICE), mesh->vertexCount * sizeof(GOOFY_VERTICE), mesh->vertices);
+// a piece of the file that ends at a line end, counted and then parsed by one thread
+typedef struct {
+    const char* start;
+    const char* end;
+    size_t lines, positions, texCoords, normals; // from the counting pass
+    GOOFY_OBJ_STATE state; // its own welding table, the keys are global v/vt/vn but the indices point into state.keys
+    unsigned int* remap; // chunk vertex -> mesh vertex
+    size_t indexBase;
+} GOOFY_OBJ_CHUNK;
+typedef struct {
+    GOOFY_OBJ_CHUNK* chunks;
+    size_t chunkCount;
+    float* positions;
+    float* texCoords;
+    float* normals;
+    const unsigned int* keys; // of the whole mesh
+    GOOFY_VERTICE* vertices;
+    size_t vertexCount, vertexRange;
+    unsigned int* indices;
+} GOOFY_OBJ_JOB;
 
-    unsigned int* adjustedIndices = malloc(sizeof(unsigned int) * mesh->indexCount);
-    for (size_t i = 0; i < mesh->indexCount; ++i) {
-        adjustedIndices[i] = mesh->indices[i] + buffer->currentVerticeOffset;
+static void goofy_countObjChunk(void* context, size_t item) {
+    GOOFY_OBJ_CHUNK* chunk = &((GOOFY_OBJ_JOB*)context)->chunks[item];
+    for (const char* cursor = chunk->start; cursor < chunk->end;) {
+        const char* newline = (const char*)memchr(cursor, '\n', (size_t)(chunk->end - cursor));
+        const char* lineEnd = newline ? newline : chunk->end;
+        const char* end = (lineEnd > cursor && lineEnd[-1] == '\r') ? lineEnd - 1 : lineEnd;
+        const char* p = cursor;
+        switch (goofy_objLineType(&p, end)) {
+        case 'v': chunk->positions++; break;
+        case 't': chunk->texCoords++; break;
+        case 'n': chunk->normals++; break;
+        default: break;
+        }
+        chunk->lines++;
+        cursor = lineEnd + 1;
     }
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer->EBO);
-    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, buffer->currentIndiceOffset * sizeof(unsigned int), mesh->indexCount * sizeof(unsigned int), adjustedIndices);
-    free(adjustedIndices);
-
-    size_t idx = buffer->meshCount++;
-    buffer->vertexOffsets[idx] = buffer->currentVerticeOffset;
-    buffer->indexOffsets[idx] = buffer->currentIndiceOffset;
-    buffer->currentIndiceOffset += mesh->indexCount;
-    buffer->currentVerticeOffset += mesh->vertexCount;
-    buffer->vertexCounts[idx] = mesh->vertexCount;
-    buffer->indexCounts[idx] = mesh->indexCount;
 }
-void goofy_drawAllMeshes(GOOFY_BUFFER* buffer, GLuint shaderProgram,GOOFY_TEXTURE_ARRAY* textureArray) {
-    if (buffer->meshCount == 0) return;
-
-    glBindVertexArray(buffer->VAO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer->EBO);
-
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray->textureArray);
-    glUniform1i(glGetUniformLocation(shaderProgram, "textureArray"),0);
-
-    GLsizei* countArray = malloc(sizeof(GLsizei) * buffer->meshCount);
-    const void** indexOffsetArray = malloc(sizeof(void*) * buffer->meshCount);
-    GLint* baseVertexArray = malloc(sizeof(GLint) * buffer->meshCount);
-
-    for (size_t i = 0; i < buffer->meshCount; ++i) {
-        countArray[i] = (GLsizei)buffer->indexCounts[i];
-        indexOffsetArray[i] = (const void*)(buffer->indexOffsets[i] * sizeof(unsigned int));
-        baseVertexArray[i] = 0; // indices already adjusted
-    }
-
-    glMultiDrawElementsBaseVertex(
-        GL_TRIANGLES,
-        countArray,
-        GL_UNSIGNED_INT,
-        indexOffsetArray,
-        (GLsizei)buffer->meshCount,
-        baseVertexArray
-    );
-    buffer->currentIndiceOffset = 0;
-    buffer->currentVerticeOffset = 0;
-    buffer->meshCount = 0;
-    free(countArray);
-    free(indexOffsetArray);
-    free(baseVertexArray);
-
-    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+// the v/vt/vn arrays of the state point into the mesh wide ones and are exactly as big as counted, so they never get realloced
+static void goofy_parseObjChunk(void* context, size_t item) {
+    GOOFY_ZONE_BEGIN("goofy_objMeshParallel chunk");
+    GOOFY_OBJ_CHUNK* chunk = &((GOOFY_OBJ_JOB*)context)->chunks[item];
+    for (const char* cursor = chunk->start; cursor < chunk->end && !chunk->state.outOfMemory;) {
+        const char* newline = (const char*)memchr(cursor, '\n', (size_t)(chunk->end - cursor));
+        const char* lineEnd = newline ? newline : chunk->end;
+        goofy_parseObjLine(&chunk->state, cursor, lineEnd);
+        cursor = lineEnd + 1;
+    }
+    GOOFY_ZONE_END();
 }
-void goofy_terminate() {
-    for (short i = 0; i < goofy_trashRegistryCount; ++i) {
-        if (goofy_trashRegistry[i]) {
-            goofy_freeTrashBatch(goofy_trashRegistry[i]);
-            goofy_trashRegistry[i] = NULL;
-        }
+// the first chunkCount items copy the remapped indices of a chunk, the rest build a range of vertices
+static void goofy_assembleObjChunk(void* context, size_t item) {
+    GOOFY_OBJ_JOB* job = (GOOFY_OBJ_JOB*)context;
+    if (item < job->chunkCount) {
+        const GOOFY_OBJ_CHUNK* chunk = &job->chunks[item];
+        unsigned int* indices = job->indices + chunk->indexBase;
+        for (size_t i = 0; i < chunk->state.indexCount; ++i) indices[i] = chunk->remap[chunk->state.indices[i]];
+        return;
+    }
+    size_t first = (item - job->chunkCount) * job->vertexRange;
+    size_t last = first + job->vertexRange < job->vertexCount ? first + job->vertexRange : job->vertexCount;
+    for (size_t v = first; v < last; ++v) {
+        goofy_buildObjVertex(&job->vertices[v], job->keys + v * 3, job->positions, job->texCoords, job->normals);
     }
-    goofy_trashRegistryCount = 0;
-    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
-    glBindVertexArray(0);
 }
 
-// FILE-LOADING functions
-GOOFY_MESH goofy_objMesh(const char* filepath) {
-    GOOFY_MESH result = {0}; 
-    FILE* file = fopen(filepath, "r");
-    if (!file) {
-        fprintf(stderr, "[GOOFYLIB3] Failed to open OBJ file: %s\n", filepath);
-        return result;  
+GOOFY_MESH goofy_objMeshParallel(const char* filepath, unsigned int threadCount) {
+    GOOFY_MESH result = {0};
+    if (threadCount == 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        threadCount = cores > 0 ? (unsigned int)cores : 1;
     }
+    if (threadCount > GOOFY_OBJ_MAX_THREADS) threadCount = GOOFY_OBJ_MAX_THREADS;
 
-    char line[2048];
-    int bufferAmount = 2048;
+    int fd = open(filepath, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "[GOOFYLIB3] Failed to open OBJ file: %s\n", filepath);
+        return result;
+    }
+    // small files arent worth the threads, and if mapping fails the normal loader still works
+    struct stat info;
+    if (threadCount < 2 || fstat(fd, &info) != 0 || info.st_size < GOOFY_OBJ_BLOCK || (uint64_t)info.st_size > SIZE_MAX) {
+        close(fd);
+        return goofy_objMesh(filepath);
+    }
+    size_t size = (size_t)info.st_size;
+    void* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return goofy_objMesh(filepath);
+    madvise(map, size, MADV_WILLNEED);
 
-    float *x = (float *)malloc(sizeof(float) * bufferAmount);
-    float *y = (float *)malloc(sizeof(float) * bufferAmount);
-    float *z = (float *)malloc(sizeof(float) * bufferAmount);
-    int vertexCap = bufferAmount;
-    int vertex = 0;
+    GOOFY_ZONE_BEGIN("goofy_objMeshParallel");
+    printf("[GOOFYLIB3] Parsing OBJ file: %s (%u threads)\n", filepath, threadCount);
+    GOOFY_OBJ_JOB job;
+    memset(&job, 0, sizeof(job));
+    GOOFY_OBJ_STATE merged;
+    memset(&merged, 0, sizeof(merged));
+    char outOfMemory = 0;
 
-    float *vtx = (float *)malloc(sizeof(float) * bufferAmount);
-    float *vty = (float *)malloc(sizeof(float) * bufferAmount);
-    int texCap = bufferAmount;
-    int texCoord = 0;
+    // a few chunks per thread so one slow chunk doesnt hold up the rest, but at least a block each
+    size_t chunkCount = (size_t)threadCount * 4;
+    if (chunkCount > size / GOOFY_OBJ_BLOCK) chunkCount = size / GOOFY_OBJ_BLOCK;
+    size_t chunkSize = size / chunkCount;
+    job.chunks = (GOOFY_OBJ_CHUNK*)calloc(chunkCount, sizeof(GOOFY_OBJ_CHUNK));
+    if (!job.chunks) outOfMemory = 1;
+    const char* text = (const char*)map;
+    const char* textEnd = text + size;
+    for (const char* start = text; job.chunks && start < textEnd && job.chunkCount < chunkCount; job.chunkCount++) {
+        const char* end = textEnd;
+        if (job.chunkCount + 1 < chunkCount && (size_t)(textEnd - start) > chunkSize) {
+            const char* newline = (const char*)memchr(start + chunkSize, '\n', (size_t)(textEnd - start) - chunkSize);
+            if (newline) end = newline + 1;
+        }
+        job.chunks[job.chunkCount].start = start;
+        job.chunks[job.chunkCount].end = end;
+        start = end;
+    }
 
-    float *nx = (float *)malloc(sizeof(float) * bufferAmount);
-    float *ny = (float *)malloc(sizeof(float) * bufferAmount);
-    float *nz = (float *)malloc(sizeof(float) * bufferAmount);
-    int normalCap = bufferAmount;
-    int normal = 0;
+    // 1. count v/vt/vn per chunk, then everything can go straight to its final place
+    size_t positionCount = 0, texCoordCount = 0, normalCount = 0, lines = 0;
+    if (!outOfMemory) {
+        goofy_parallelFor(threadCount, job.chunkCount, goofy_countObjChunk, &job);
+        for (size_t c = 0; c < job.chunkCount; ++c) {
+            GOOFY_OBJ_CHUNK* chunk = &job.chunks[c];
+            chunk->state.positionBase = positionCount;
+            chunk->state.texCoordBase = texCoordCount;
+            chunk->state.normalBase = normalCount;
+            chunk->state.line = lines;
+            positionCount += chunk->positions;
+            texCoordCount += chunk->texCoords;
+            normalCount += chunk->normals;
+            lines += chunk->lines;
+        }
+        job.positions = positionCount ? (float*)malloc(sizeof(float) * 3 * positionCount) : NULL;
+        job.texCoords = texCoordCount ? (float*)malloc(sizeof(float) * 2 * texCoordCount) : NULL;
+        job.normals = normalCount ? (float*)malloc(sizeof(float) * 3 * normalCount) : NULL;
+        outOfMemory = (positionCount && !job.positions) || (texCoordCount && !job.texCoords) || (normalCount && !job.normals);
+    }
 
+    // 2. parse, faces can already check their indices because the bases are known
+    if (!outOfMemory) {
+        for (size_t c = 0; c < job.chunkCount; ++c) {
+            GOOFY_OBJ_CHUNK* chunk = &job.chunks[c];
+            if (chunk->positions) chunk->state.positions = job.positions + chunk->state.positionBase * 3;
+            if (chunk->texCoords) chunk->state.texCoords = job.texCoords + chunk->state.texCoordBase * 2;
+            if (chunk->normals) chunk->state.normals = job.normals + chunk->state.normalBase * 3;
+            chunk->state.positionCapacity = chunk->positions * 3;
+            chunk->state.texCoordCapacity = chunk->texCoords * 2;
+            chunk->state.normalCapacity = chunk->normals * 3;
+        }
+        goofy_parallelFor(threadCount, job.chunkCount, goofy_parseObjChunk, &job);
+    }
 
-    int faces = 0;
+    // 3. weld the chunk vertices together in file order, so the mesh comes out exactly like goofy_objMesh makes it
+    size_t indexCount = 0, faces = 0, badLines = 0;
+    for (size_t c = 0; c < job.chunkCount; ++c) {
+        GOOFY_OBJ_CHUNK* chunk = &job.chunks[c];
+        outOfMemory |= chunk->state.outOfMemory;
+        faces += chunk->state.faces;
+        badLines += chunk->state.badLines;
+        chunk->indexBase = indexCount;
+        indexCount += chunk->state.indexCount;
+        free(chunk->state.table);
+        free(chunk->state.corners);
+        chunk->state.table = NULL;
+        chunk->state.corners = NULL;
+        if (outOfMemory || !chunk->state.vertexCount) continue;
 
-    printf("[GOOFYLIB3] Parsing OBJ file: %s\n", filepath);
-    while (fgets(line, sizeof(line), file)) {
-        if (line[0] == '#' || line[0] == '\n') continue;
-    
-        if (strncmp(line, "vt ", 3) == 0) {
-            if (texCoord >= vertexCap) {
-                bufferAmount += INCREASE;
-                vtx = realloc(vtx, sizeof(float) * bufferAmount);
-                vty = realloc(vty, sizeof(float) * bufferAmount);
-                vertexCap = bufferAmount;
-            }
-            sscanf(line, "vt %f %f", &vtx[texCoord], &vty[texCoord]);
-            texCoord++;
-        } else if (strncmp(line, "vn ", 3) == 0) {
-            if (normal >= vertexCap) {
-                bufferAmount += INCREASE;
-                nx = realloc(nx, sizeof(float) * bufferAmount);
-                ny = realloc(ny, sizeof(float) * bufferAmount);
-                nz = realloc(nz, sizeof(float) * bufferAmount);
-                vertexCap = bufferAmount;
-            }
-            sscanf(line, "vn %f %f %f", &nx[normal], &ny[normal], &nz[normal]);
-            normal++;
-        } else if (strncmp(line, "v ", 2) == 0) {
-            if (vertex >= vertexCap) {
-                bufferAmount += INCREASE;
-                x = realloc(x, sizeof(float) * bufferAmount);
-                y = realloc(y, sizeof(float) * bufferAmount);
-                z = realloc(z, sizeof(float) * bufferAmount);
-                vertexCap = bufferAmount;
+        chunk->remap = (unsigned int*)malloc(sizeof(unsigned int) * chunk->state.vertexCount);
+        if (!chunk->remap) {
+            outOfMemory = 1;
+            continue;
+        }
+        for (size_t v = 0; v < chunk->state.vertexCount; ++v) {
+            unsigned int vertex = goofy_weldObjCorner(&merged, chunk->state.keys + v * 3);
+            if (vertex == UINT_MAX) {
+                outOfMemory = 1;
+                break;
             }
-            sscanf(line, "v %f %f %f", &x[vertex], &y[vertex], &z[vertex]);
-            vertex++;
-        } else if (strncmp(line, "f ", 2) == 0) {
-            faces++;
+            chunk->remap[v] = vertex;
         }
+        free(chunk->state.keys);
+        chunk->state.keys = NULL;
     }
 
-    printf("[GOOFYLIB3] Parsed %d vertices, %d texture coords, %d normals, %d faces\n", vertex, texCoord, normal, faces);
+    // 4. build the vertices and copy the indices over
+    if (!outOfMemory && merged.vertexCount) {
+        job.vertices = (GOOFY_VERTICE*)malloc(sizeof(GOOFY_VERTICE) * merged.vertexCount);
+        job.indices = indexCount ? (unsigned int*)malloc(sizeof(unsigned int) * indexCount) : NULL;
+        if (!job.vertices || (indexCount && !job.indices)) outOfMemory = 1;
+    }
+    if (!outOfMemory && merged.vertexCount) {
+        size_t ranges = (size_t)threadCount * 4;
+        job.keys = merged.keys;
+        job.vertexCount = merged.vertexCount;
+        job.vertexRange = (merged.vertexCount + ranges - 1) / ranges;
+        goofy_parallelFor(threadCount, job.chunkCount + (merged.vertexCount + job.vertexRange - 1) / job.vertexRange, goofy_assembleObjChunk, &job);
+    }
 
-    result.vertexCount = faces * 3;  
-    result.indexCount = faces * 3;
-    result.vertices = malloc(sizeof(GOOFY_VERTICE) * result.indexCount);
-    result.indices = malloc(sizeof(unsigned int) * result.indexCount);
+    munmap(map, size);
+    for (size_t c = 0; job.chunks && c < job.chunkCount; ++c) {
+        free(job.chunks[c].state.keys);
+        free(job.chunks[c].state.table);
+        free(job.chunks[c].state.corners);
+        free(job.chunks[c].state.indices);
+        free(job.chunks[c].remap);
+    }
+    free(job.chunks);
+    free(job.positions);
+    free(job.texCoords);
+    free(job.normals);
+    free(merged.keys);
+    free(merged.table);
 
-    if (!result.vertices || !result.indices) {
+    if (outOfMemory) {
         fprintf(stderr, "[GOOFYLIB3] Memory allocation failed\n");
-
-        if (result.vertices) free(result.vertices);
-        if (result.indices)  free(result.indices);
-
-        free(x); free(y); free(z);
-        free(vtx); free(vty);
-        free(nx); free(ny); free(nz);
-
-        fclose(file);
+        free(job.vertices);
+        free(job.indices);
+        GOOFY_ZONE_END();
         return result;
     }
+    if (badLines > 10) fprintf(stderr, "[GOOFYLIB3] Warning: %zu bad lines in total\n", badLines);
+    printf("[GOOFYLIB3] Parsed %zu vertices, %zu texture coords, %zu normals, %zu faces\n", positionCount, texCoordCount, normalCount, faces);
 
-    int indexCount = 0;
-    int vertexCount = 0;
-    rewind(file);  
-    while (fgets(line, sizeof(line), file)) {
-        if (strncmp(line, "f ", 2) == 0) {
-            int vIndex[3], tIndex[3], nIndex[3];
-            int parsedCount = sscanf(line, "f %d/%d/%d %d/%d/%d %d/%d/%d", 
-                                      &vIndex[0], &tIndex[0], &nIndex[0], 
-                                      &vIndex[1], &tIndex[1], &nIndex[1], 
-                                      &vIndex[2], &tIndex[2], &nIndex[2]);
-
-            if (parsedCount == 9) {
-                /*
-                printf("  Parsed face: v/t/n %d/%d/%d %d/%d/%d %d/%d/%d\n", 
-                        vIndex[0], tIndex[0], nIndex[0],
-                        vIndex[1], tIndex[1], nIndex[1],
-                        vIndex[2], tIndex[2], nIndex[2]);
-                */
-
-                GOOFY_VERTICE v[3];
-                for (int i = 0; i < 3; ++i) {
-                    int vi = vIndex[i] - 1;
-                    int ti = tIndex[i] - 1;
-                    int ni = nIndex[i] - 1;
-
-                    v[i].position[0] = x[vi];
-                    v[i].position[1] = y[vi];
-                    v[i].position[2] = z[vi];
-                    v[i].texCoords[0] = vtx[ti];
-                    v[i].texCoords[1] = vty[ti];
-                    v[i].normals[0] = nx[ni];
-                    v[i].normals[1] = ny[ni];
-                    v[i].normals[2] = nz[ni];
-                    v[i].colors[0] = 1.0f;
-                    v[i].colors[1] = 1.0f;
-                    v[i].colors[2] = 1.0f;
-                    v[i].texIndex = 0;
-                    v[i].is3d = 1;
-                    //CPE1704TKS
-                    if (vIndex[i] <= 0 || vIndex[i] > vertex ||
-                        tIndex[i] <= 0 || tIndex[i] > texCoord ||
-                        nIndex[i] <= 0 || nIndex[i] > normal) {
-                        fprintf(stderr, "[GOOFYLIB3] Error: Face index out of bounds on line: %s", line);
-                        continue;
-                    }
-                    /*
-                    printf("    Vertex %d: Pos(%f, %f, %f) Tex(%f, %f) Norm(%f, %f, %f)\n",
-                        i, v[i].position[0], v[i].position[1], v[i].position[2],
-                        v[i].texCoords[0], v[i].texCoords[1],
-                        v[i].normals[0], v[i].normals[1], v[i].normals[2]);
-                    */
-                }
-                
-                for (int i = 0; i < 3; ++i)
-                    result.vertices[vertexCount++] = v[i];
-
-                result.indices[indexCount++] = vertexCount - 3;
-                result.indices[indexCount++] = vertexCount - 2;
-                result.indices[indexCount++] = vertexCount - 1;
-            } else {
-                fprintf(stderr, "[GOOFYLIB3] Warning: Malformed face line: %s", line);
-            }
-        }
-    }
-
-    printf("[GOOFYLIB3] Final mesh: %d vertices, %d indices\n", vertexCount, indexCount);
+    result.vertices = job.vertices;
+    result.indices = job.indices;
+    result.vertexCount = merged.vertexCount;
+    result.indexCount = indexCount;
 
-    free(x); free(y); free(z);
-    free(vtx); free(vty);
-    free(nx); free(ny); free(nz);
-    fclose(file);
+    printf("[GOOFYLIB3] Final mesh: %zu vertices, %zu indices\n", result.vertexCount, result.indexCount);
+    goofy_initMeshState(&result);
+    GOOFY_ZONE_END();
     return result;
 }
+#else
+GOOFY_MESH goofy_objMeshParallel(const char* filepath, unsigned int threadCount) {
+    (void)threadCount;
+    return goofy_objMesh(filepath);
+}
+#endif
 
 // TEXTURE-RELATED functions
 GOOFY_TEXTURE_ARRAY goofy_initTextures(int textureWidth, int textureHeight, int numLayers) {
@@ -475,6 +3708,7 @@ GLuint goofy_loadTexture(const char* path, int layerIndex,GOOFY_TEXTURE_ARRAY* t
         printf("[GOOFYLIB3] Not loading texture : %s because texture array is full.\n", path);
         return -1;
     }
+    GOOFY_ZONE_BEGIN("goofy_loadTexture");
     textureArray->currentLayers += 1;
     int width, height, nrChannels;
     stbi_set_flip_vertically_on_load(1);  
@@ -482,47 +3716,79 @@ GLuint goofy_loadTexture(const char* path, int layerIndex,GOOFY_TEXTURE_ARRAY* t
 
     if (!data) {
         printf("[GOOFYLIB3] Failed to load texture: %s\n", path);
+        GOOFY_ZONE_END();
         return -1; 
     }
     GLenum format = (nrChannels == 3) ? GL_RGB : GL_RGBA;
     glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray->textureArray);
     glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layerIndex, width, height, 1, format, GL_UNSIGNED_BYTE, data);
     glGenerateMipmap(GL_TEXTURE_2D_ARRAY); 
+    goofy_stats.frame.textureUploads++;
+    goofy_stats.frame.mipGenerations++;
+    goofy_stats.frame.bytesUploaded += (uint64_t)width * height * nrChannels;
     stbi_image_free(data);
 
     printf("[GOOFYLIB3] Loaded texture: %s into layer %d\n", path, layerIndex);
     glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    GOOFY_ZONE_END();
     return layerIndex;
 }
 
 // MESH-MODIFICATION functions
+void goofy_markMeshChanged(GOOFY_MESH* mesh, size_t firstVertex, size_t vertexCount, size_t firstIndex, size_t indexCount) {
+    if (mesh->dirtyVertexStart >= mesh->dirtyVertexEnd && mesh->dirtyIndexStart >= mesh->dirtyIndexEnd) {
+        mesh->dirtySince = mesh->version; // first change since the last upload
+    }
+    goofy_extendRange(&mesh->dirtyVertexStart, &mesh->dirtyVertexEnd, firstVertex, vertexCount);
+    goofy_extendRange(&mesh->dirtyIndexStart, &mesh->dirtyIndexEnd, firstIndex, indexCount);
+    if (vertexCount) mesh->boundsValid = 0;
+    mesh->version = goofy_nextMeshVersion();
+}
 void goofy_transformMesh(GOOFY_MESH* mesh, float x, float y, float z) {
+    GOOFY_ZONE_BEGIN("goofy_transformMesh");
+    goofy_markMeshChanged(mesh, 0, mesh->vertexCount, 0, 0);
     for (int i = 0; i < mesh->vertexCount; i++) {
         mesh->vertices[i].position[0] += x;
         mesh->vertices[i].position[1] += y;
         mesh->vertices[i].position[2] += z;
     }
+    GOOFY_ZONE_END();
 }
 void goofy_resizeMesh(GOOFY_MESH* mesh, float x, float y, float z) {
+    GOOFY_ZONE_BEGIN("goofy_resizeMesh");
+    goofy_markMeshChanged(mesh, 0, mesh->vertexCount, 0, 0);
     for (int i = 0; i < mesh->vertexCount; i++) {
         mesh->vertices[i].position[0] *= x;
         mesh->vertices[i].position[1] *= y;
         mesh->vertices[i].position[2] *= z;
     }
+    GOOFY_ZONE_END();
 }
 void goofy_setMeshTexture(GOOFY_MESH* mesh, int texIndex) {
+    GOOFY_ZONE_BEGIN("goofy_setMeshTexture");
+    char boundsValid = mesh->boundsValid; // positions stay the same
+    goofy_markMeshChanged(mesh, 0, mesh->vertexCount, 0, 0);
+    mesh->boundsValid = boundsValid;
     for (size_t i = 0; i < mesh->vertexCount; i++) {
         mesh->vertices[i].texIndex = texIndex;
     }
+    GOOFY_ZONE_END();
 }
 void goofy_setMeshColor(GOOFY_MESH* mesh, float r,float g,float b) {
+    GOOFY_ZONE_BEGIN("goofy_setMeshColor");
+    char boundsValid = mesh->boundsValid;
+    goofy_markMeshChanged(mesh, 0, mesh->vertexCount, 0, 0);
+    mesh->boundsValid = boundsValid;
     for (size_t i = 0; i < mesh->vertexCount; i++) {
         mesh->vertices[i].colors[0] = r;
         mesh->vertices[i].colors[1] = g;
         mesh->vertices[i].colors[2] = b;
     }
+    GOOFY_ZONE_END();
 }
 void goofy_rotateMesh(GOOFY_MESH* mesh, float angleRad, float axisX, float axisY, float axisZ) {
+    GOOFY_ZONE_BEGIN("goofy_rotateMesh");
+    goofy_markMeshChanged(mesh, 0, mesh->vertexCount, 0, 0);
     float centerX = 0, centerY = 0, centerZ = 0;
     for (size_t i = 0; i < mesh->vertexCount; i++) {
         centerX += mesh->vertices[i].position[0];
@@ -565,6 +3831,7 @@ void goofy_rotateMesh(GOOFY_MESH* mesh, float angleRad, float axisX, float axisY
         n[1] = rot[1][0]*x + rot[1][1]*y + rot[1][2]*z;
         n[2] = rot[2][0]*x + rot[2][1]*y + rot[2][2]*z;
     }
+    GOOFY_ZONE_END();
 }
 // MEMORY-RELATED functions
 GOOFY_MESH* goofy_cloneMesh(const GOOFY_MESH* original) {
@@ -575,6 +3842,9 @@ GOOFY_MESH* goofy_cloneMesh(const GOOFY_MESH* original) {
 
     clone->vertexCount = original->vertexCount;
     clone->indexCount = original->indexCount;
+    goofy_initMeshState(clone);
+    clone->bounds = original->bounds;
+    clone->boundsValid = original->boundsValid;
 
     clone->vertices = (GOOFY_VERTICE*)malloc(sizeof(GOOFY_VERTICE) * clone->vertexCount);
     if (!clone->vertices) {
@@ -598,6 +3868,7 @@ void goofy_reallocateMesh(GOOFY_MESH* mesh, size_t newVertexCapacity, size_t new
     mesh->indices = realloc(mesh->indices, sizeof(unsigned int) * newIndexCapacity);
     mesh->vertexCount += newVertexCapacity;
     mesh->indexCount += newIndexCapacity;
+    goofy_markMeshChanged(mesh, 0, mesh->vertexCount, 0, mesh->indexCount);
     if (!mesh->vertices || !mesh->indices) {
         fprintf(stderr, "[GOOFYLIB3] Failed to reallocate mesh memory\n");
         exit(1);
@@ -605,6 +3876,7 @@ void goofy_reallocateMesh(GOOFY_MESH* mesh, size_t newVertexCapacity, size_t new
 }
 GOOFY_MESH goofy_appendMesh(const GOOFY_MESH* a,const GOOFY_MESH* b) {
     GOOFY_MESH result;
+    goofy_initMeshState(&result);
     result.vertexCount = a->vertexCount + b->vertexCount;
     result.indexCount = a->indexCount + b->indexCount;
     result.vertices = malloc(sizeof(GOOFY_VERTICE) * result.vertexCount);
@@ -628,15 +3900,76 @@ void goofy_freeBuffer(GOOFY_BUFFER* buffer) {
     if (buffer->indexOffsets) free(buffer->indexOffsets);
     if (buffer->vertexCounts) free(buffer->vertexCounts);
     if (buffer->indexCounts) free(buffer->indexCounts);
+    if (buffer->indexTypes) free(buffer->indexTypes);
+    if (buffer->instanceCounts) free(buffer->instanceCounts);
+    if (buffer->baseInstances) free(buffer->baseInstances);
+    if (buffer->instances) free(buffer->instances);
+    if (buffer->scratch) free(buffer->scratch);
+    if (buffer->slots) free(buffer->slots);
+    if (buffer->drawCounts) free(buffer->drawCounts);
+    if (buffer->drawIndexOffsets) free(buffer->drawIndexOffsets);
+    if (buffer->drawBaseVertices) free(buffer->drawBaseVertices);
+    if (buffer->commands) free(buffer->commands);
+    if (buffer->indirectBuffer) glDeleteBuffers(1, &buffer->indirectBuffer);
+    if (buffer->drawData) free(buffer->drawData);
+    if (buffer->drawDataBuffer) glDeleteBuffers(1, &buffer->drawDataBuffer);
+    if (buffer->concurrent) {
+        free(buffer->concurrent->stagingVertices);
+        free(buffer->concurrent->stagingIndices);
+        free(buffer->concurrent->boxes);
+        free(buffer->concurrent);
+        buffer->concurrent = NULL;
+    }
+    if (buffer->boundsBuffer) {
+        glDeleteBuffers(1, &buffer->boundsBuffer);
+        glDeleteBuffers(1, &buffer->culledCommandBuffer);
+        glDeleteBuffers(1, &buffer->culledDrawBuffer);
+    }
+
+    if (buffer->fences) {
+        for (unsigned int i = 0; i < buffer->frameCount; ++i) {
+            if (buffer->fences[i]) glDeleteSync(buffer->fences[i]);
+        }
+        free(buffer->fences);
+        buffer->fences = NULL;
+    }
 
+    // deleting a mapped buffer unmaps it
     glDeleteBuffers(1, &buffer->VBO);
     glDeleteBuffers(1, &buffer->EBO);
+    glDeleteBuffers(1, &buffer->instanceVBO);
     glDeleteVertexArrays(1, &buffer->VAO);
+    buffer->mappedVertices = NULL;
+    buffer->mappedIndices = NULL;
 
     buffer->vertexOffsets = NULL;
     buffer->indexOffsets = NULL;
     buffer->vertexCounts = NULL;
     buffer->indexCounts = NULL;
+    buffer->instanceCounts = NULL;
+    buffer->baseInstances = NULL;
+    buffer->instances = NULL;
+    buffer->scratch = NULL;
+    buffer->scratchSize = 0;
+    buffer->instanceCapacity = 0;
+    buffer->instanceCount = 0;
+    buffer->slots = NULL;
+    buffer->slotCount = 0;
+    buffer->slotCapacity = 0;
+    buffer->drawCounts = NULL;
+    buffer->drawIndexOffsets = NULL;
+    buffer->drawBaseVertices = NULL;
+    buffer->drawCapacity = 0;
+    buffer->commands = NULL;
+    buffer->commandCapacity = 0;
+    buffer->indirectBuffer = 0;
+    buffer->drawData = NULL;
+    buffer->drawDataCapacity = 0;
+    buffer->drawDataBuffer = 0;
+    buffer->boundsBuffer = 0;
+    buffer->culledCommandBuffer = 0;
+    buffer->culledDrawBuffer = 0;
+    buffer->culledCapacity = 0;
 }
 void goofy_freeMesh(GOOFY_MESH* mesh) {
     if (!mesh) return;
@@ -767,6 +4100,7 @@ GOOFY_MESH goofy_cubeMesh(float x,float y,float z,float width,float height,float
     };
     mesh.indexCount = 36;
     mesh.vertexCount = 24;
+    goofy_initMeshState(&mesh);
     mesh.vertices = (GOOFY_VERTICE*)malloc(sizeof(GOOFY_VERTICE) * mesh.vertexCount);
     mesh.indices = (unsigned int*)malloc(sizeof(unsigned int) * mesh.indexCount);
     if (!mesh.vertices || !mesh.indices) {
@@ -781,6 +4115,7 @@ GOOFY_MESH* goofy_createSphere(float radius, unsigned int sectorCount, unsigned
     GOOFY_MESH* sphere = (GOOFY_MESH*)malloc(sizeof(GOOFY_MESH));
     if (!sphere) return NULL;
 
+    goofy_initMeshState(sphere);
     sphere->vertexCount = (stackCount + 1) * (sectorCount + 1);
     sphere->indexCount = stackCount * sectorCount * 6;
 
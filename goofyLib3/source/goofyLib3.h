@@ -1,9 +1,109 @@
 #ifndef GOOFYLIB3_H
 #define GOOFYLIB3_H
 
+#include <stdint.h>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include "shaderloader.h"
+
+typedef struct {
+    float position[3];
+    float colors[3];
+    float normals[3];
+    float texCoords[2];
+    int texIndex; 
+    unsigned int is3d;
+} GOOFY_VERTICE;
+
+typedef struct {
+    unsigned short position[3]; // unorm16 inside the box of the mesh, see goofy_initPackedBuffer
+    short texIndex;
+    unsigned int normal; // signed normalized 10_10_10_2
+    unsigned char colors[4]; // rgb and is3d in the last byte
+    unsigned short texCoords[2]; // half floats
+} GOOFY_PACKED_VERTICE; // 20 bytes instead of 52, used by goofy_initPackedBuffer
+
+typedef enum {
+    GOOFY_VERTEX_FULL,
+    GOOFY_VERTEX_PACKED,
+    GOOFY_VERTEX_CUSTOM
+} GOOFY_VERTEX_FORMAT;
+
+typedef enum {
+    GOOFY_ATTRIBUTE_POSITION,
+    GOOFY_ATTRIBUTE_COLOR,
+    GOOFY_ATTRIBUTE_NORMAL,
+    GOOFY_ATTRIBUTE_TEXCOORD,
+    GOOFY_ATTRIBUTE_TEXINDEX,
+    GOOFY_ATTRIBUTE_IS3D
+} GOOFY_ATTRIBUTE_SOURCE; // which GOOFY_VERTICE field an attribute gets its data from
+
+typedef struct {
+    GLuint location;
+    GOOFY_ATTRIBUTE_SOURCE source;
+    GLenum type; // GL_FLOAT, GL_HALF_FLOAT, GL_UNSIGNED_BYTE, GL_SHORT, GL_INT_2_10_10_10_REV...
+    GLint components;
+    GLboolean normalized;
+    char integer; // 1 = glVertexAttribIPointer (int/uint in the shader)
+    size_t offset;
+} GOOFY_VERTEX_ATTRIBUTE;
+
+#define GOOFY_MAX_ATTRIBUTES 8
+
+typedef struct {
+    GOOFY_VERTEX_ATTRIBUTE attributes[GOOFY_MAX_ATTRIBUTES];
+    int attributeCount;
+    size_t stride;
+} GOOFY_VERTEX_LAYOUT; // what a buffer stores per vertex, only these attributes get uploaded
+
+typedef struct {
+    size_t vertexOffset, vertexCount, vertexCapacity;
+    size_t indexOffset, indexCount, indexCapacity; // offset and capacity in 16 bit units
+    GLenum indexType;
+    float bounds[4]; // bounding sphere of the mesh (center, radius) before the slot transform
+    const void* mesh; // the GOOFY_MESH that was uploaded last (only compared) and its version, so unchanged meshes arent uploaded again
+    unsigned int meshVersion;
+    char used;
+    char visible;
+} GOOFY_MESH_SLOT; // a retained mesh living inside a GOOFY_BUFFER, unused slots keep their capacity for reuse
+
+typedef struct {
+    float transform[16]; // column major, like glUniformMatrix4fv with transpose GL_FALSE
+    float tint[3];
+    int texIndex; // -1 = use the texIndex of the vertices
+    float positionScale[4]; // set by the library: position * positionScale + positionOffset is the real position (w unused)
+    float positionOffset[4]; // packed buffers store positions inside the mesh box, everywhere else it is scale 1 offset 0
+} GOOFY_INSTANCE; // per instance data for goofy_renderMeshInstanced, in the shader: layout(location = 6) in mat4, 10 in vec3 tint, 11 in int texIndex,
+// 12 in vec3 positionScale, 13 in vec3 positionOffset
+
+#define GOOFY_INSTANCE_LOCATION 6
+#define GOOFY_INSTANCE_ATTRIBUTES 8 // locations GOOFY_INSTANCE_LOCATION to GOOFY_INSTANCE_LOCATION + 7
+
+typedef struct {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+} GOOFY_DRAW_COMMAND; // same layout as DrawElementsIndirectCommand
+
+typedef struct {
+    uint64_t meshesSubmitted; // stream meshes, slot uploads and instanced meshes
+    uint64_t meshesDropped; // goofy_renderMeshConcurrent calls that didnt fit
+    uint64_t verticesUploaded;
+    uint64_t indicesUploaded;
+    uint64_t bytesUploaded; // vertices, indices, indirect commands, slot data and instances
+    uint64_t drawCalls; // gl draw calls, a multi draw is one
+    uint64_t multiDrawCommands; // draws inside the multi draws
+    uint64_t stateBinds; // programs, VAOs and textures bound for drawing
+    uint64_t textureUploads;
+    uint64_t mipGenerations;
+    uint64_t arrayGrowths; // reallocs when the buffer, instance, draw and render queue arrays grow (not every malloc of the library)
+} GOOFY_COUNTERS;
+
+typedef struct GOOFY_SUBMIT_STATE GOOFY_SUBMIT_STATE; // atomics for goofy_renderMeshConcurrent, lives in goofyLib3.c
+
 typedef struct {
     GLuint VAO, VBO, EBO;
     size_t MAX_MESHES;
@@ -13,33 +113,233 @@ typedef struct {
     size_t* indexOffsets;
     size_t* vertexCounts;
     size_t* indexCounts;
+    GLenum* indexTypes; // GL_UNSIGNED_SHORT when the mesh has at most 65536 vertices, else GL_UNSIGNED_INT
+    GLuint* instanceCounts;
+    GLuint* baseInstances;
 
     size_t currentVerticeOffset;
     size_t currentIndiceOffset;
+
+    GOOFY_VERTEX_LAYOUT layout;
+    GOOFY_VERTEX_FORMAT vertexFormat; // full and packed layouts get fast uploads
+    size_t vertexSize; // bytes per vertex on the GPU
+    unsigned char* scratch; // meshes get converted here before glBufferSubData
+    size_t scratchSize;
+
+    // index list of the last submitted mesh, for goofy_renderMeshSharedIndices
+    const unsigned int* lastIndices;
+    size_t lastIndexCount;
+    size_t lastIndexOffset;
+    GLenum lastIndexType;
+
+    size_t maxVertices; // per frame region
+    size_t maxIndices; // per frame region, in 16 bit units (a 32 bit index takes 2)
+    size_t vertexCeiling; // how far the buffer is allowed to grow (goofy_setBufferCeiling)
+    size_t indexCeiling;
+    size_t meshCeiling;
+
+    // persistent ring mode (goofy_initRingBuffer), frameCount is 1 for normal buffers
+    unsigned int frameCount;
+    unsigned int currentFrame;
+    char frameReady; // 1 when the current region has been waited on
+    GLsync* fences;
+    unsigned char* mappedVertices;
+    unsigned short* mappedIndices;
+
+    // instance data (goofy_renderMeshInstanced), instance 0 is the identity used by normal meshes
+    GLuint instanceVBO;
+    GOOFY_INSTANCE* instances;
+    size_t instanceCount;
+    size_t instanceCapacity;
+
+    // retained meshes (goofy_addMeshSlot), stored from the end of the buffer downwards
+    GOOFY_MESH_SLOT* slots;
+    size_t slotCount;
+    size_t slotCapacity;
+    size_t retainedVertexBase;
+    size_t retainedIndexBase;
+
+    // per slot draw data (goofy_setMeshSlotTransform), a shader storage buffer indexed by gl_DrawID
+    GLuint drawDataBuffer;
+    GOOFY_INSTANCE* drawData;
+    size_t drawDataCapacity;
+    size_t drawDataDirtyStart;
+    size_t drawDataDirtyEnd;
+    size_t drawDataSlotCount; // slot count the gpu copy has
+
+    // gpu culling (goofy_drawAllMeshesCulled), sized like the indirect commands
+    GLuint boundsBuffer; // slot bounding spheres
+    GLuint culledCommandBuffer; // visible slot commands, 16 bit half then 32 bit half
+    GLuint culledDrawBuffer; // a GoofyDraws block of the visible slots per half, then an empty one for stream meshes
+    size_t culledCapacity;
+    size_t culledRegionSize;
+
+    // concurrent submission (goofy_beginConcurrentSubmit), made on first use
+    GOOFY_SUBMIT_STATE* concurrent;
+
+    GOOFY_COUNTERS counters; // everything that went through this buffer since it was made (textures are never counted here)
+
+    // draw parameters kept between frames so drawing doesnt malloc
+    GLsizei* drawCounts;
+    const void** drawIndexOffsets;
+    GLint* drawBaseVertices;
+    size_t drawCapacity;
+
+    // indirect draws (goofy_drawAllMeshesIndirect), one command per slot then the stream meshes
+    GLuint indirectBuffer;
+    GOOFY_DRAW_COMMAND* commands;
+    size_t commandCapacity;
+    size_t commandDirtyStart;
+    size_t commandDirtyEnd;
 } GOOFY_BUFFER; // can be (probably with context sharing)
 
 typedef struct {
-    float position[3];
-    float colors[3];
-    float normals[3];
-    float texCoords[2];
-    int texIndex; 
-    unsigned int is3d;
-} GOOFY_VERTICE;
+    float min[3];
+    float max[3];
+    float sphere[4]; // center and radius, around the middle of the box
+} GOOFY_BOUNDS;
 
 typedef struct {
     GOOFY_VERTICE* vertices;
     size_t vertexCount;
     unsigned int* indices;
     size_t indexCount;
+    GOOFY_BOUNDS bounds; // only valid when boundsValid is 1, use goofy_meshBounds
+    char boundsValid; // the MESH-MODIFICATION functions set it back to 0, do it yourself when you edit vertices by hand
+    unsigned int version; // changes with every edit, 0 = not tracked (always uploaded in full)
+    unsigned int dirtySince; // the version the dirty ranges are relative to
+    size_t dirtyVertexStart, dirtyVertexEnd;
+    size_t dirtyIndexStart, dirtyIndexEnd;
 } GOOFY_MESH; // can be shared between windows
 
+typedef struct {
+    float* centerX; // SoA so the culling tests 4 (SSE) or 8 (AVX) spheres at once
+    float* centerY;
+    float* centerZ;
+    float* radius;
+    size_t count;
+    size_t capacity;
+} GOOFY_CULL_LIST;
+
 typedef struct {
     GLuint textureArray;
     int numLayers;
     int currentLayers;
 } GOOFY_TEXTURE_ARRAY; // cant be shared between windows
 
+typedef struct {
+    char* name; // arrays without the [0]
+    uint32_t hash;
+    GLint location;
+    GLenum type;
+    GLint arraySize;
+    size_t valueOffset; // where the last sent value lives in GOOFY_SHADER.values
+    char set;
+} GOOFY_UNIFORM;
+
+typedef struct {
+    GLuint program;
+    GOOFY_UNIFORM* uniforms;
+    int uniformCount;
+    int* buckets; // hash table of uniform indices, -1 = empty
+    int bucketCount;
+    unsigned char* values; // shadow copy of what the program currently has, unchanged values dont get sent again
+    int textureArrayUniform;
+} GOOFY_SHADER; // uniform table of a program, built once with glGetActiveUniform
+
+typedef struct {
+    float view[16];
+    float projection[16];
+    float viewProjection[16];
+    float cameraPosition[4];
+    float lightDirection[4];
+    float lightColor[4];
+    float time;
+    float deltaTime;
+    float screenSize[2];
+} GOOFY_FRAME_CONSTANTS; // std140, in glsl:
+// layout(std140) uniform GoofyFrame { mat4 view; mat4 projection; mat4 viewProjection; vec4 cameraPosition; vec4 lightDirection; vec4 lightColor; float time; float deltaTime; vec2 screenSize; };
+
+typedef struct {
+    GLuint frameUBO; // GoofyFrame block, bound to GOOFY_FRAME_BINDING
+    GLuint batchUBO; // ring for GoofyBatch blocks, ranges get bound to GOOFY_BATCH_BINDING
+    size_t batchSize; // per frame region
+    size_t batchOffset; // used bytes in the current region
+    size_t alignment; // GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+    unsigned int frameCount;
+    unsigned int currentFrame;
+    char frameReady;
+    GLsync* fences;
+    unsigned char* mappedBatches; // NULL without OpenGL 4.4, then glBufferSubData is used
+} GOOFY_UNIFORM_BUFFER; // constants shared by every program, one buffer update instead of a uniform call per program
+
+typedef struct {
+    const char* name; // the scope name, or the draw function for buffer draws
+    const GOOFY_BUFFER* buffer; // NULL for goofy_beginGpuScope scopes
+    unsigned int depth; // how many scopes were open around it
+    unsigned int calls; // scopes with the same name, buffer and depth in a frame get added together
+    double milliseconds;
+} GOOFY_GPU_SCOPE_TIME;
+
+typedef struct {
+    unsigned long long frame; // which goofy_beginGpuFrame it was, starting at 0
+    double milliseconds; // goofy_beginGpuFrame to goofy_endGpuFrame on the GPU
+    GOOFY_GPU_SCOPE_TIME* scopes; // in the order they were opened
+    size_t scopeCount;
+} GOOFY_GPU_FRAME_REPORT;
+
+typedef struct {
+    GLuint* queries; // GL_TIMESTAMP pairs, (scopeCapacity + 1) per frame region, pair 0 is the whole frame
+    GOOFY_GPU_SCOPE_TIME* pending; // what every pair measures
+    size_t* pendingCounts; // pairs used per region
+    unsigned long long* regionFrames;
+    size_t* openScopes; // stack of the pairs that are open right now
+    size_t openCount;
+    size_t scopeCapacity; // per frame
+    unsigned int frameCount;
+    unsigned int currentFrame;
+    unsigned long long frame;
+    char active;
+    char reportReady;
+    unsigned int droppedOpen; // dropped scopes that are still open, their ends are ignored
+    size_t droppedScopes; // didnt fit into scopeCapacity
+    size_t droppedFrames; // the GPU still wasnt done when the region came around again
+    GOOFY_GPU_FRAME_REPORT report; // the newest frame that came back
+} GOOFY_GPU_TIMER; // timestamp queries read back frameCount frames later so nothing waits for the GPU
+
+#define GOOFY_HISTOGRAM_BUCKETS 32
+typedef struct {
+    uint64_t buckets[GOOFY_HISTOGRAM_BUCKETS]; // bucket i counts calls that took 2^i to 2^(i+1) nanoseconds
+    uint64_t count;
+    uint64_t totalNanoseconds;
+    uint64_t maxNanoseconds;
+} GOOFY_HISTOGRAM;
+
+typedef struct {
+    GOOFY_COUNTERS frame; // since the last goofy_endStatsFrame
+    GOOFY_COUNTERS lastFrame;
+    GOOFY_COUNTERS total; // all finished frames
+    GOOFY_HISTOGRAM renderMesh; // latencies since the start or goofy_resetStats
+    GOOFY_HISTOGRAM drawAllMeshes; // all goofy_drawAllMeshes* functions and goofy_drawRenderQueue
+    GOOFY_HISTOGRAM frameTime; // cpu time between two goofy_endStatsFrame calls
+    uint64_t frames;
+} GOOFY_STATS;
+
+typedef struct {
+    uint64_t key; // shader | texture array | VAO | depth, 16 bits each
+    GOOFY_BUFFER* buffer;
+    GLuint shaderProgram;
+    GOOFY_TEXTURE_ARRAY* textureArray;
+    char indirect;
+} GOOFY_QUEUE_ITEM;
+
+typedef struct {
+    GOOFY_QUEUE_ITEM* items;
+    GOOFY_QUEUE_ITEM* sorted; // radix sort ping pongs between the two arrays
+    size_t count;
+    size_t capacity;
+} GOOFY_RENDER_QUEUE; // collects buffer draws and draws them sorted so shaders, VAOs and textures switch as little as possible
+
 typedef enum {
     GOOFY_TRASH_MESH,
     GOOFY_TRASH_BUFFER,
@@ -61,22 +361,212 @@ typedef struct {
 
 GLFWwindow* goofy_initWindow(const char* windowName, int width, int height, int major_version, int minor_version);
 // Initializes a OpenGL window and context. Returns a pointer to a window, inputs are the name of window, width of window, height of window, major OpenGL version, minor OpenGL version
+GLFWwindow* goofy_initHeadless(int width, int height, int major_version, int minor_version);
+// Same as goofy_initWindow but the window is never shown and vsync is off, for benchmarks and servers. Render into your own framebuffer object.
+// With GLFW 3.4 built with the null platform it needs no display at all, the context comes from OSMesa (llvmpipe with Mesa). Otherwise it is a hidden EGL window.
 GLuint goofy_initShaders(const char* vertexPath,const char* fragmentPath);
 // Initializes shaders from a vertex shader and fragment shader glsl file. Returns ID of shader. Inputs are filepaths of each shader file.
 GOOFY_BUFFER goofy_initBuffer(GLuint maxVertices, GLuint maxIndices, size_t maxMeshes);
 // Returns a GOOFY_BUFFER object for drawing. Returns the GOOFY_BUFFER object. MaxVertices determines how many vertices can fit in the buffer. Maxindices determine the max indices (vertex ids) which are stored. MaxMeshes are each independent mesh.
+// These are only the starting sizes, the buffer doubles itself when it gets full (see goofy_setBufferCeiling). MaxIndices counts 32 bit indices, 16 bit ones take half the space.
 // YOU CAN SHARE BUFFERS BETWEEN WINDOWS
+GOOFY_BUFFER goofy_initRingBuffer(GLuint maxVertices, GLuint maxIndices, size_t maxMeshes, unsigned int frameCount);
+// Same as goofy_initBuffer but the VBO/EBO are persistently mapped and split into frameCount regions (maxVertices/maxIndices EACH) guarded by fences.
+// goofy_renderMesh then just memcpys into the mapped memory instead of calling glBufferSubData. Needs OpenGL 4.4, falls back to a normal buffer if not. 3 frames is a good number.
+GOOFY_BUFFER goofy_initPackedBuffer(GLuint maxVertices, GLuint maxIndices, size_t maxMeshes, unsigned int frameCount);
+// Same as goofy_initRingBuffer (frameCount 1 = normal buffer) but vertices are stored as GOOFY_PACKED_VERTICE on the GPU.
+// Meshes stay normal GOOFY_MESH and get converted when uploaded, the attribute locations are the same. Positions are 16 bit steps inside the box
+// of the mesh (goofy_meshBounds), so 1/65535 of its size on every axis no matter where it is. The vertex shader gets them as 0..1 and has to decode them:
+// position * positionScale + positionOffset, from the instance attributes (12 and 13) or for slots from goofyDraws[gl_DrawID] (see GOOFY_INSTANCE).
+// Other buffers have scale 1 and offset 0 there, so the same shader works for both. Every stream mesh gets its own instance record for its box,
+// goofy_drawAllMeshes draws them one by one like instanced meshes (goofy_drawAllMeshesIndirect keeps them in one multi draw).
+GOOFY_BUFFER goofy_initBufferLayout(GLuint maxVertices, GLuint maxIndices, size_t maxMeshes, unsigned int frameCount, const GOOFY_VERTEX_LAYOUT* layout);
+// Same as goofy_initRingBuffer (frameCount 1 = normal buffer) but with your own vertex layout, see the VERTEX-LAYOUT functions.
+// Locations GOOFY_INSTANCE_LOCATION to GOOFY_INSTANCE_LOCATION + GOOFY_INSTANCE_ATTRIBUTES - 1 (6-13) are taken by the instance attributes.
+void goofy_setBufferCeiling(GOOFY_BUFFER* buffer, size_t maxVertices, size_t maxIndices, size_t maxMeshes);
+// Sets the max size a buffer can grow to (per frame region for ring buffers). Set them to the current sizes to stop it from growing.
 void goofy_renderMesh(GOOFY_BUFFER* buffer, GOOFY_MESH* mesh);
 // Adds a mesh to a GOOFY_BUFFER rendering queue. Inputs are the GOOFY_BUFFER to add to, and the mesh pointer, and the shader ID.
+// Indices are uploaded as they are and offset on the GPU with the base vertex. Meshes with up to 65536 vertices get 16 bit indices on the GPU automatically.
+void goofy_renderRawMesh(GOOFY_BUFFER* buffer, const void* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount);
+// Adds vertices that are ALREADY in the buffer's layout, they get copied without any conversion. Packed positions of raw meshes are not decoded (scale 1, offset 0).
+void goofy_renderMeshSharedIndices(GOOFY_BUFFER* buffer, GOOFY_MESH* mesh);
+// Same as goofy_renderMesh but only uploads the vertices and reuses the index list of the previous submitted mesh if it was the same one.
+// Good for drawing one mesh many times with goofy_transformMesh in between. DONT change the indices in between calls.
+void goofy_renderMeshInstanced(GOOFY_BUFFER* buffer, GOOFY_MESH* mesh, const GOOFY_INSTANCE* instances, size_t instanceCount);
+// Uploads a mesh once and draws it instanceCount times, each with its own GOOFY_INSTANCE (transform, tint, texture layer).
+// Your vertex shader has to use the instance attributes (see GOOFY_INSTANCE) for this to do anything. positionScale/positionOffset of the instances get overwritten.
+GOOFY_INSTANCE goofy_translationInstance(float x, float y, float z);
+// Returns a GOOFY_INSTANCE that just moves the mesh, white tint and the mesh's own texture.
 void goofy_drawAllMeshes(GOOFY_BUFFER* buffer, GLuint shaderProgram,GOOFY_TEXTURE_ARRAY* textureArray);
 // Draws all meshes within a GOOFY_BUFFER object.
+void goofy_drawAllMeshesIndirect(GOOFY_BUFFER* buffer, GLuint shaderProgram,GOOFY_TEXTURE_ARRAY* textureArray);
+// Same as goofy_drawAllMeshes but with one glMultiDrawElementsIndirect from a command buffer kept on the GPU.
+// Slot commands are only re-uploaded when a slot changes. Needs OpenGL 4.3, falls back to goofy_drawAllMeshes if not.
+void goofy_drawAllMeshesCulled(GOOFY_BUFFER* buffer, GLuint shaderProgram,GOOFY_TEXTURE_ARRAY* textureArray, const float* viewProjection);
+// Same as goofy_drawAllMeshesIndirect but a compute shader first tests every slot's bounding sphere (moved by its slot transform) against the frustum
+// of viewProjection (column major) and only the visible slots get drawn. Stream meshes are always drawn. The draw count stays on the GPU with
+// OpenGL 4.6 or ARB_indirect_parameters. gl_DrawID still finds the slot data in GoofyDraws.
 void goofy_terminate();
 // Deletes all GOOFY_TRASH_BATCH items and terminates stuff. YOU NEED TO RUN THIS AT THE END OF PROGRAM
 
+// VERTEX-LAYOUT functions
+GOOFY_VERTEX_LAYOUT goofy_initLayout(void);
+// Returns an empty vertex layout.
+void goofy_addLayoutAttribute(GOOFY_VERTEX_LAYOUT* layout, GLuint location, GOOFY_ATTRIBUTE_SOURCE source, GLenum type, GLint components, GLboolean normalized, char integer);
+// Adds an attribute at the end of the layout. Example: a UI quad only needs position (GL_FLOAT, 3) and texcoord (GL_FLOAT, 2), 20 bytes per vertex.
+// Locations 6-13 belong to the instance attributes (see GOOFY_INSTANCE) and get rejected, use 0-5 or 14 and up.
+GOOFY_VERTEX_LAYOUT goofy_fullLayout(void);
+// The normal GOOFY_VERTICE layout.
+GOOFY_VERTEX_LAYOUT goofy_packedLayout(void);
+// The GOOFY_PACKED_VERTICE layout.
+void goofy_convertVertices(const GOOFY_VERTEX_LAYOUT* layout, const GOOFY_VERTICE* vertices, void* converted, size_t count);
+// Converts vertices into a layout. converted needs count * layout->stride bytes.
+
+// CONCURRENT-SUBMIT functions
+// Lets worker threads add stream meshes at the same time. Only begin and end call OpenGL, they have to run on the GL thread.
+char goofy_beginConcurrentSubmit(GOOFY_BUFFER* buffer, size_t maxVertices, size_t maxIndices, size_t maxMeshes);
+// Grows the buffer so maxVertices/maxIndices/maxMeshes more fit (0 = whatever fits right now), the workers cant grow it.
+// Ring buffers get written straight into their mapped memory, normal buffers into cpu memory that goofy_endConcurrentSubmit uploads in one go.
+char goofy_renderMeshConcurrent(GOOFY_BUFFER* buffer, GOOFY_MESH* mesh);
+// Same as goofy_renderMesh but from any thread, space is taken with compare and swap and the copies run in parallel. Returns 0 if it didnt fit,
+// then it takes no space so smaller meshes after it can still fit. The first one per submit is printed, meshesDropped in the stats counts all of them.
+// Packed buffers compute the bounds of the mesh (goofy_meshBounds), dont hand the same changed mesh to two threads at once.
+void goofy_endConcurrentSubmit(GOOFY_BUFFER* buffer);
+// Call after ALL workers are done (joined), uploads what they wrote. Draw the buffer like normal after this.
+
+// RETAINED-MESH functions
+// Retained meshes are uploaded once and drawn by goofy_drawAllMeshes every frame until removed, for static stuff.
+int goofy_addMeshSlot(GOOFY_BUFFER* buffer, GOOFY_MESH* mesh);
+// Uploads a mesh into the buffer permanently. Returns the slot handle, or -1 if the buffer is full.
+void goofy_updateMeshSlot(GOOFY_BUFFER* buffer, int slot, GOOFY_MESH* mesh);
+// Re-uploads a slot with new mesh data. The handle stays the same even if the mesh got bigger.
+// If it is the same mesh as last time only what changed since then gets uploaded (nothing if it didnt change), see goofy_markMeshChanged.
+void goofy_setMeshSlotVisible(GOOFY_BUFFER* buffer, int slot, char visible);
+// Hides or shows a slot without touching its data.
+void goofy_removeMeshSlot(GOOFY_BUFFER* buffer, int slot);
+// Releases a slot, its space gets reused by later goofy_addMeshSlot calls.
+void goofy_setMeshSlotTransform(GOOFY_BUFFER* buffer, int slot, const float* transform);
+// Sets the model matrix (column major) of a slot. Only these 64 bytes get uploaded, the vertices stay as they are.
+void goofy_setMeshSlotColor(GOOFY_BUFFER* buffer, int slot, float r, float g, float b);
+// Sets the tint of a slot.
+void goofy_setMeshSlotTexture(GOOFY_BUFFER* buffer, int slot, int texIndex);
+// Sets the texture layer of a slot, -1 = use the texIndex of the vertices.
+// Slot draw data is a GOOFY_INSTANCE per slot in a shader storage buffer (needs OpenGL 4.3), in glsl 4.6 (or ARB_shader_draw_parameters):
+// struct GoofyDraw { mat4 transform; vec3 tint; int texIndex; vec4 positionScale; vec4 positionOffset; };
+// layout(std430, binding = 0) readonly buffer GoofyDraws { uint goofySlotCount; GoofyDraw goofyDraws[]; };
+// A draw is a slot when gl_BaseInstance == 0 && gl_DrawID < goofySlotCount, then its data is goofyDraws[gl_DrawID]. Stream meshes use the identity.
+
+// RENDER-QUEUE functions
+GOOFY_RENDER_QUEUE goofy_initRenderQueue(size_t capacity);
+// Returns an empty render queue, it grows when more than capacity draws get queued.
+void goofy_queueBuffer(GOOFY_RENDER_QUEUE* queue, GOOFY_BUFFER* buffer, GLuint shaderProgram, GOOFY_TEXTURE_ARRAY* textureArray, float depth);
+// Queues a goofy_drawAllMeshes of the buffer. Depth only orders draws with the same shader, texture array and buffer (smaller first).
+// Queue every buffer only once per goofy_drawRenderQueue, drawing it resets its stream meshes.
+void goofy_queueBufferIndirect(GOOFY_RENDER_QUEUE* queue, GOOFY_BUFFER* buffer, GLuint shaderProgram, GOOFY_TEXTURE_ARRAY* textureArray, float depth);
+// Same but draws like goofy_drawAllMeshesIndirect.
+void goofy_drawRenderQueue(GOOFY_RENDER_QUEUE* queue);
+// Sorts the queued draws by their key (radix sort), draws them and empties the queue. Programs, VAOs and textures are only switched when they change.
+void goofy_freeRenderQueue(GOOFY_RENDER_QUEUE* queue);
+// Frees the queue arrays.
+
+// SHADER-UNIFORM functions
+GOOFY_SHADER* goofy_getShader(GLuint program);
+// Returns the uniform table of a program. goofy_initShaders builds it, other programs get one the first time they are asked for. Keep the pointer around.
+void goofy_deleteShader(GLuint program);
+// Deletes the program and its uniform table.
+int goofy_findUniform(GOOFY_SHADER* shader, const char* name);
+// Returns the index of a uniform (arrays without [0]) or -1 if the program doesnt have it. Look it up once and keep it, not every frame.
+void goofy_setUniformInt(GOOFY_SHADER* shader, int uniform, int value);
+// Also for bools and samplers (texture unit).
+void goofy_setUniformFloat(GOOFY_SHADER* shader, int uniform, float value);
+void goofy_setUniformVec2(GOOFY_SHADER* shader, int uniform, const float* values);
+void goofy_setUniformVec3(GOOFY_SHADER* shader, int uniform, const float* values);
+void goofy_setUniformVec4(GOOFY_SHADER* shader, int uniform, const float* values);
+void goofy_setUniformMat4(GOOFY_SHADER* shader, int uniform, const float* matrix);
+// Matrices are column major.
+void goofy_setUniformArray(GOOFY_SHADER* shader, int uniform, const void* values, int count);
+// Sets count elements of any uniform type, values has to match the type of the uniform (floats, ints or unsigned ints).
+// The setters use glProgramUniform (OpenGL 4.1) so the program doesnt have to be bound, and skip the call when the value didnt change.
+// On older contexts they bind the program for glUniform and put the old one back.
+
+// UNIFORM-BUFFER functions
+GOOFY_UNIFORM_BUFFER goofy_initUniformBuffer(size_t batchSize, unsigned int frameCount);
+// Makes the GoofyFrame UBO and a ring of frameCount regions of batchSize bytes for GoofyBatch blocks (3 frames is good).
+// Programs made by goofy_initShaders get their GoofyFrame/GoofyBatch blocks bound to GOOFY_FRAME_BINDING/GOOFY_BATCH_BINDING automatically.
+void goofy_setFrameConstants(GOOFY_UNIFORM_BUFFER* uniforms, const GOOFY_FRAME_CONSTANTS* constants);
+// Uploads the per frame constants, every program with a GoofyFrame block sees them. Call once per frame.
+char goofy_pushBatchConstants(GOOFY_UNIFORM_BUFFER* uniforms, const void* data, size_t size);
+// Copies a std140 GoofyBatch block into the ring and binds it, the next draws use it. Returns 0 if the region for this frame is full.
+void goofy_endUniformFrame(GOOFY_UNIFORM_BUFFER* uniforms);
+// Call after the draws of a frame, moves the ring to the next region.
+void goofy_freeUniformBuffer(GOOFY_UNIFORM_BUFFER* uniforms);
+// Deletes the UBOs.
+
+// GPU-TIMING functions
+GOOFY_GPU_TIMER goofy_initGpuTimer(size_t maxScopes, unsigned int frameCount);
+// Makes a ring of frameCount regions (4 is good) of timestamp queries, every region fits maxScopes scopes per frame. Needs OpenGL 3.3.
+void goofy_beginGpuFrame(GOOFY_GPU_TIMER* timer);
+// Starts a frame. Until goofy_endGpuFrame every goofy_drawAllMeshes* call and render queue draw gets timed per buffer.
+// Also reads back the frame that used this region before, if the GPU is done with it (it never waits).
+void goofy_beginGpuScope(GOOFY_GPU_TIMER* timer, const char* name);
+// Opens a named scope, they can be nested. The name is not copied, use string literals.
+void goofy_endGpuScope(GOOFY_GPU_TIMER* timer);
+// Closes the newest open scope.
+void goofy_endGpuFrame(GOOFY_GPU_TIMER* timer);
+// Closes the scopes that are still open and ends the frame. Call before swapping buffers.
+const GOOFY_GPU_FRAME_REPORT* goofy_gpuFrameReport(const GOOFY_GPU_TIMER* timer);
+// Returns the newest frame the GPU finished (frameCount - 1 frames old), NULL until the first one is back.
+void goofy_printGpuFrameReport(const GOOFY_GPU_FRAME_REPORT* report);
+// Prints every scope of a report indented by depth.
+void goofy_freeGpuTimer(GOOFY_GPU_TIMER* timer);
+// Deletes the queries.
+
+// STATS functions
+// Counters are always on and only counted on the GL thread (goofy_renderMeshConcurrent meshes are counted by goofy_endConcurrentSubmit).
+const GOOFY_STATS* goofy_getStats(void);
+// Returns the library wide stats, per buffer counters are in buffer->counters.
+void goofy_endStatsFrame(void);
+// Call once per frame after drawing, moves the frame counters into lastFrame and total (and prints them every goofy_setStatsDumpInterval frames).
+void goofy_setStatsDumpInterval(unsigned int frames);
+// Prints the stats every that many frames, 0 = never (the default).
+void goofy_printStats(void);
+// Prints the last frame, the totals and the latency percentiles.
+char goofy_writeStatsJson(const char* path);
+// Writes the stats as JSON (counters, histogram buckets and p50/p90/p99) so runs can be compared by a script. Returns 0 if the file cant be written.
+uint64_t goofy_histogramPercentile(const GOOFY_HISTOGRAM* histogram, double percentile);
+// Returns the upper end in nanoseconds of the bucket the percentile (0 - 100) falls into, 0 if the histogram is empty.
+void goofy_resetStats(void);
+// Sets all library wide stats back to 0.
+
+// TRACING functions
+// Build with GOOFY_TRACE defined to record cpu zones, without it GOOFY_ZONE_BEGIN/GOOFY_ZONE_END compile to nothing.
+// Every thread writes into its own ring (GOOFY_TRACE_RING_SIZE zones, oldest get overwritten) so nothing locks.
+// Zones are timed with a monotonic nanosecond clock (not the glfw timer) so they work before glfwInit too.
+#ifdef GOOFY_TRACE
+uint64_t goofy_traceNow(void);
+void goofy_traceZone(const char* name, uint64_t start, uint64_t end);
+#define GOOFY_ZONE_BEGIN(name) const char* goofyZoneName = (name); uint64_t goofyZoneStart = goofy_traceNow()
+#define GOOFY_ZONE_END() goofy_traceZone(goofyZoneName, goofyZoneStart, goofy_traceNow())
+#else
+#define GOOFY_ZONE_BEGIN(name) ((void)0)
+#define GOOFY_ZONE_END() ((void)0)
+#endif
+// One zone per function, END has to run before every return. The name is not copied, use string literals.
+char goofy_writeTrace(const char* path);
+// Writes the recorded zones as Chrome trace JSON (open it in ui.perfetto.dev or chrome://tracing). Returns 0 if tracing is off or the file cant be written.
+// Call it while the other threads arent recording.
+void goofy_clearTrace(void);
+// Forgets the recorded zones.
+
 // FILE-LOADING functions
 
 GOOFY_MESH goofy_objMesh(const char* filepath);
-// Loads an OBJ file of this format (v/vt/vn), MUST be that format.
+// Loads an OBJ file (v, vt, vn and f). Faces can be v, v/vt, v//vn or v/vt/vn with negative indices too, polygons get split into triangles.
+// Corners with the same v/vt/vn share one vertex, the mesh is indexed. Bad lines are skipped with a warning.
+GOOFY_MESH goofy_objMeshParallel(const char* filepath, unsigned int threadCount);
+// Same mesh as goofy_objMesh but the file is memory mapped and parsed on threadCount threads (0 = all cores), for big files.
+// Small files (under 1 MB), 1 thread or platforms without mmap/pthreads just use goofy_objMesh. Link with -pthread.
 
 // TEXTURE-RELATED functions
 
@@ -86,7 +576,25 @@ GOOFY_TEXTURE_ARRAY goofy_initTextures(int textureWidth, int textureHeight, int
 GLuint goofy_loadTexture(const char* path, int layerIndex,GOOFY_TEXTURE_ARRAY* textureArray);
 // Loads a texture to the 3D Texture array.
 
+// CULLING functions
+const GOOFY_BOUNDS* goofy_meshBounds(GOOFY_MESH* mesh);
+// Returns the AABB and bounding sphere of a mesh, only computed again after the mesh changed.
+GOOFY_CULL_LIST goofy_initCullList(size_t capacity);
+// Returns an empty list of bounding spheres, it grows when more get added.
+size_t goofy_addCullSphere(GOOFY_CULL_LIST* list, const float* sphere);
+// Adds a sphere (center x, y, z and radius in world space) and returns its index. Example: goofy_addCullSphere(&list, goofy_meshBounds(&mesh)->sphere)
+size_t goofy_cullSpheres(const GOOFY_CULL_LIST* list, const float* viewProjection, unsigned int* visible);
+// Tests every sphere against the frustum of viewProjection (column major) and writes the indices of the visible ones into visible (needs list->count entries).
+// Returns how many are visible. Uses AVX or SSE when the compiler has them enabled.
+void goofy_clearCullList(GOOFY_CULL_LIST* list);
+// Removes all spheres but keeps the memory.
+void goofy_freeCullList(GOOFY_CULL_LIST* list);
+// Frees the list arrays.
+
 // MESH-MODIFICATION functions
+// These bump the mesh version and mark the vertices they touched as dirty.
+void goofy_markMeshChanged(GOOFY_MESH* mesh, size_t firstVertex, size_t vertexCount, size_t firstIndex, size_t indexCount);
+// Call after editing mesh->vertices or mesh->indices by hand, with the ranges you changed (counts can be 0).
 void goofy_transformMesh(GOOFY_MESH* mesh, float x, float y, float z);
 // Transforms a mesh by adding the X,Y,Z values.
 void goofy_resizeMesh(GOOFY_MESH* mesh, float x, float y, float z);
@@ -99,6 +607,9 @@ void goofy_rotateMesh(GOOFY_MESH* mesh, float angleRad, float axisX, float axisY
 // Rotates a mesh along an axis.
 
 // MEMORY-RELATED functions
+void goofy_packVertices(const GOOFY_VERTICE* vertices, GOOFY_PACKED_VERTICE* packed, size_t count, const GOOFY_BOUNDS* box);
+// Converts vertices to the packed format used by goofy_initPackedBuffer, positions inside box (goofy_meshBounds of the mesh, NULL = they are already 0..1).
+
 GOOFY_MESH* goofy_cloneMesh(const GOOFY_MESH* original);
 // Lets you clone a mesh.
 
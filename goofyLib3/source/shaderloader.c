@@ -3,6 +3,9 @@
 #include <string.h>
 #include <glad/glad.h>
 
+#include "shaderloader.h"
+#include "goofyLib3.h" // GOOFY_ZONE_BEGIN/GOOFY_ZONE_END
+
 char* load_shader_source(const char* filepath) {
     FILE* file = fopen(filepath, "rb");
     if (!file) {
@@ -44,11 +47,30 @@ GLuint compile_shader(GLenum type, const char* source) {
     return shader;
 }
 
+void bind_uniform_blocks(GLuint program) {
+    GLuint frameBlock = glGetUniformBlockIndex(program, GOOFY_FRAME_BLOCK);
+    if (frameBlock != GL_INVALID_INDEX) {
+        glUniformBlockBinding(program, frameBlock, GOOFY_FRAME_BINDING);
+    }
+    GLuint batchBlock = glGetUniformBlockIndex(program, GOOFY_BATCH_BLOCK);
+    if (batchBlock != GL_INVALID_INDEX) {
+        glUniformBlockBinding(program, batchBlock, GOOFY_BATCH_BINDING);
+    }
+    if (GLAD_GL_VERSION_4_3) {
+        GLuint drawBlock = glGetProgramResourceIndex(program, GL_SHADER_STORAGE_BLOCK, GOOFY_DRAW_BLOCK);
+        if (drawBlock != GL_INVALID_INDEX) {
+            glShaderStorageBlockBinding(program, drawBlock, GOOFY_DRAW_BINDING);
+        }
+    }
+}
+
 GLuint create_shader_program(const char* vertexPath, const char* fragmentPath) {
+    GOOFY_ZONE_BEGIN("create_shader_program");
     char* vertexSource = load_shader_source(vertexPath);
     char* fragmentSource = load_shader_source(fragmentPath);
 
     if (vertexSource == NULL || fragmentSource == NULL) {
+        GOOFY_ZONE_END();
         return 0;
     }
 
@@ -66,6 +88,8 @@ GLuint create_shader_program(const char* vertexPath, const char* fragmentPath) {
         char log[512];
         glGetProgramInfoLog(shaderProgram, 512, NULL, log);
         fprintf(stderr, "Shader Linking Error: %s\n", log);
+    } else {
+        bind_uniform_blocks(shaderProgram);
     }
 
     glDeleteShader(vertexShader);
@@ -75,5 +99,26 @@ GLuint create_shader_program(const char* vertexPath, const char* fragmentPath) {
     free(vertexSource);
     free(fragmentSource);
     
+    GOOFY_ZONE_END();
     return shaderProgram;
 }
+
+GLuint create_compute_program(const char* computeSource) {
+    GLuint computeShader = compile_shader(GL_COMPUTE_SHADER, computeSource);
+
+    GLuint computeProgram = glCreateProgram();
+    glAttachShader(computeProgram, computeShader);
+    glLinkProgram(computeProgram);
+    glDeleteShader(computeShader);
+
+    GLint success;
+    glGetProgramiv(computeProgram, GL_LINK_STATUS, &success);
+    if (!success) {
+        char log[512];
+        glGetProgramInfoLog(computeProgram, 512, NULL, log);
+        fprintf(stderr, "Compute Shader Linking Error: %s\n", log);
+        glDeleteProgram(computeProgram);
+        return 0;
+    }
+    return computeProgram;
+}
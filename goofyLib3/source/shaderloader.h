@@ -3,6 +3,17 @@
 
 #include <glad/glad.h>
 
+// uniform blocks that get their binding point set automatically
+#define GOOFY_FRAME_BLOCK "GoofyFrame"
+#define GOOFY_FRAME_BINDING 0
+#define GOOFY_BATCH_BLOCK "GoofyBatch"
+#define GOOFY_BATCH_BINDING 1
+// shader storage blocks have their own binding points
+#define GOOFY_DRAW_BLOCK "GoofyDraws"
+#define GOOFY_DRAW_BINDING 0
+
 GLuint create_shader_program(const char* vertexPath, const char* fragmentPath);
+void bind_uniform_blocks(GLuint program);
+GLuint create_compute_program(const char* computeSource); // from source, returns 0 if it doesnt link
 
 #endif